@@ -1,65 +1,31 @@
 #include "niriipc.hpp"
 
+#include "nirijson.hpp"
+
 #include <qdir.h>
 #include <qfile.h>
+#include <qfileinfo.h>
 #include <qjsonarray.h>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
 #include <qjsonvalue.h>
 #include <qdebug.h>
+#include <qsocketnotifier.h>
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
 
 #include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <utility>
 
 namespace caelestia {
 
-// ── NiriListModel ────────────────────────────────────────────────────
-
-NiriListModel::NiriListModel(QObject* parent) : QAbstractListModel(parent) {}
-
-QHash<int, QByteArray> NiriListModel::roleNames() const {
-    return { {ObjectRole, "modelData"} };
-}
-
-int NiriListModel::rowCount(const QModelIndex& parent) const {
-    Q_UNUSED(parent);
-    return m_items.size();
-}
-
-QVariant NiriListModel::data(const QModelIndex& index, int role) const {
-    if (!index.isValid() || index.row() >= m_items.size() || index.row() < 0) return {};
-    if (role == ObjectRole) return m_items.at(index.row());
-    return {};
-}
-
-void NiriListModel::resetData(const QVariantList& items) {
-    beginResetModel();
-    m_items = items;
-    endResetModel();
-}
-
-void NiriListModel::appendItem(const QVariantMap& item) {
-    beginInsertRows(QModelIndex(), m_items.size(), m_items.size());
-    m_items.append(item);
-    endInsertRows();
-}
-
-void NiriListModel::setItem(int idx, const QVariantMap& item) {
-    if (idx < 0 || idx >= m_items.size()) return;
-    m_items[idx] = item;
-    emit dataChanged(index(idx), index(idx), {ObjectRole});
-}
-
-void NiriListModel::removeItem(int idx) {
-    if (idx < 0 || idx >= m_items.size()) return;
-    beginRemoveRows(QModelIndex(), idx, idx);
-    m_items.removeAt(idx);
-    endRemoveRows();
-}
-
-const QVariantList& NiriListModel::items() const {
-    return m_items;
-}
-
 // ── NiriIpc ──────────────────────────────────────────────────────────
 
 NiriIpc::NiriIpc(QObject* parent)
@@ -67,13 +33,18 @@ NiriIpc::NiriIpc(QObject* parent)
     , m_eventSocket(this)
     , m_requestSocket(this) {
 
-    m_workspacesModel = new NiriListModel(this);
-    m_windowsModel = new NiriListModel(this);
+    m_workspacesModel = new NiriWorkspaceModel(this);
+    m_windowsModel = new NiriWindowModel(this);
 
     connect(&m_eventSocket, &NiriEventSocket::connected, this, &NiriIpc::onEventStreamConnected);
     connect(&m_eventSocket, &NiriEventSocket::disconnected, this, &NiriIpc::onEventStreamDisconnected);
     connect(&m_eventSocket, &NiriEventSocket::eventReceived, this, &NiriIpc::onEvent);
 
+    // Fires once the current read has been fully drained
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(0);
+    connect(&m_flushTimer, &QTimer::timeout, this, &NiriIpc::flushPending);
+
     setupLedWatchers();
     m_eventSocket.connectToNiri();
 }
@@ -82,8 +53,33 @@ NiriIpc::NiriIpc(QObject* parent)
 
 bool NiriIpc::available() const { return m_available; }
 
+bool NiriIpc::coalesceEvents() const { return m_coalesceEvents; }
+
+void NiriIpc::setCoalesceEvents(bool coalesce) {
+    if (m_coalesceEvents == coalesce) return;
+    m_coalesceEvents = coalesce;
+    if (!coalesce) {
+        m_flushTimer.stop();
+        flushPending();
+    }
+    emit coalesceEventsChanged();
+}
+
 QAbstractListModel* NiriIpc::workspacesModel() const { return m_workspacesModel; }
-QVariantList NiriIpc::workspaces() const { return m_workspacesModel->items(); }
+
+QVariantList NiriIpc::workspaces() const {
+    if (m_workspacesViewDirty) {
+        const auto& wsList = m_workspacesModel->items();
+        m_workspacesView.clear();
+        m_workspacesView.reserve(wsList.size());
+        for (const auto& ws : wsList) {
+            m_workspacesView.append(ws.toVariantMap());
+        }
+        m_workspacesViewDirty = false;
+    }
+    return m_workspacesView;
+}
+
 int NiriIpc::focusedWorkspaceIndex() const { return m_focusedWorkspaceIndex; }
 int NiriIpc::focusedWorkspaceId() const { return m_focusedWorkspaceId; }
 QString NiriIpc::focusedMonitorName() const { return m_focusedMonitorName; }
@@ -91,7 +87,20 @@ QVariantList NiriIpc::currentOutputWorkspaces() const { return m_currentOutputWo
 QVariantMap NiriIpc::workspaceHasWindows() const { return m_workspaceHasWindows; }
 
 QAbstractListModel* NiriIpc::windowsModel() const { return m_windowsModel; }
-QVariantList NiriIpc::windows() const { return m_windowsModel->items(); }
+
+QVariantList NiriIpc::windows() const {
+    if (m_windowsViewDirty) {
+        const auto& winList = m_windowsModel->items();
+        m_windowsView.clear();
+        m_windowsView.reserve(winList.size());
+        for (const auto& win : winList) {
+            m_windowsView.append(win.toVariantMap());
+        }
+        m_windowsViewDirty = false;
+    }
+    return m_windowsView;
+}
+
 int NiriIpc::focusedWindowIndex() const { return m_focusedWindowIndex; }
 QString NiriIpc::focusedWindowId() const { return m_focusedWindowId; }
 QString NiriIpc::focusedWindowTitle() const { return m_focusedWindowTitle; }
@@ -129,9 +138,189 @@ bool NiriIpc::numLock() const { return m_numLock; }
 
 // ── Actions ──────────────────────────────────────────────────────────
 
+// Known niri actions with prebuilt payloads. The argument, if any, is spliced
+// between `prefix` and `suffix`; an absent optional argument becomes null.
+namespace {
+
+enum class ActionArg {
+    None,          // Payload is `prefix` alone
+    OptionalId,    // Optional "--id N", e.g. close-window
+    RequiredId,    // Required "--id N"
+    Number,        // Single positional integer
+    OptionalDelay, // Optional "-d N"
+    SizeChange,    // Single positional size, e.g. "50%", "+10%", "-100" or "800"
+};
+
+struct ActionSpec {
+    std::string_view name;
+    ActionArg arg;
+    std::string_view prefix;
+    std::string_view suffix;
+};
+
+// Sorted by name for binary search
+constexpr std::array kActionTable{
+    ActionSpec{ "center-window", ActionArg::None, R"({"Action":{"CenterWindow":{}}})", "" },
+    ActionSpec{ "close-window", ActionArg::OptionalId, R"({"Action":{"CloseWindow":{"id":)", "}}}" },
+    ActionSpec{ "do-screen-transition", ActionArg::OptionalDelay, R"({"Action":{"DoScreenTransition":{"delay_ms":)",
+        "}}}" },
+    ActionSpec{ "expand-column-to-available-width", ActionArg::None,
+        R"({"Action":{"ExpandColumnToAvailableWidth":{}}})", "" },
+    ActionSpec{ "focus-column", ActionArg::Number, R"({"Action":{"FocusColumn":{"index":)", "}}}" },
+    ActionSpec{ "focus-window", ActionArg::RequiredId, R"({"Action":{"FocusWindow":{"id":)", "}}}" },
+    ActionSpec{ "focus-workspace", ActionArg::Number, R"({"Action":{"FocusWorkspace":{"reference":{"Index":)",
+        "}}}}" },
+    ActionSpec{ "focus-workspace-down", ActionArg::None, R"({"Action":{"FocusWorkspaceDown":{}}})", "" },
+    ActionSpec{ "focus-workspace-up", ActionArg::None, R"({"Action":{"FocusWorkspaceUp":{}}})", "" },
+    ActionSpec{ "fullscreen-window", ActionArg::None, R"({"Action":{"FullscreenWindow":{}}})", "" },
+    ActionSpec{ "maximize-column", ActionArg::None, R"({"Action":{"MaximizeColumn":{}}})", "" },
+    ActionSpec{ "move-column-to-index", ActionArg::Number, R"({"Action":{"MoveColumnToIndex":{"index":)", "}}}" },
+    ActionSpec{ "move-window-to-workspace", ActionArg::Number,
+        R"({"Action":{"MoveWindowToWorkspace":{"window_id":null,"reference":{"Index":)", R"(},"focus":true}}})" },
+    ActionSpec{ "screenshot-window", ActionArg::None,
+        R"({"Action":{"ScreenshotWindow":{"id":null,"write_to_disk":true,"path":null}}})", "" },
+    ActionSpec{ "set-column-width", ActionArg::SizeChange, R"({"Action":{"SetColumnWidth":{"change":)", "}}}" },
+    ActionSpec{ "set-window-height", ActionArg::SizeChange,
+        R"({"Action":{"SetWindowHeight":{"id":null,"change":)", "}}}" },
+    ActionSpec{ "set-window-width", ActionArg::SizeChange, R"({"Action":{"SetWindowWidth":{"id":null,"change":)",
+        "}}}" },
+    ActionSpec{ "toggle-keyboard-shortcuts-inhibit", ActionArg::None,
+        R"({"Action":{"ToggleKeyboardShortcutsInhibit":{}}})", "" },
+    ActionSpec{ "toggle-overview", ActionArg::None, R"({"Action":{"ToggleOverview":{}}})", "" },
+    ActionSpec{ "toggle-window-floating", ActionArg::OptionalId, R"({"Action":{"ToggleWindowFloating":{"id":)",
+        "}}}" },
+    ActionSpec{ "toggle-window-rule-opacity", ActionArg::None, R"({"Action":{"ToggleWindowRuleOpacity":{}}})", "" },
+    ActionSpec{ "toggle-windowed-fullscreen", ActionArg::None, R"({"Action":{"ToggleWindowedFullscreen":{}}})",
+        "" },
+};
+
+static_assert(std::is_sorted(kActionTable.begin(), kActionTable.end(),
+                  [](const ActionSpec& a, const ActionSpec& b) {
+                      return a.name < b.name;
+                  }),
+    "kActionTable must be sorted by name");
+
+const ActionSpec* findAction(std::string_view name) {
+    const auto it = std::lower_bound(kActionTable.begin(), kActionTable.end(), name,
+        [](const ActionSpec& spec, std::string_view key) {
+            return spec.name < key;
+        });
+    return it != kActionTable.end() && it->name == name ? &*it : nullptr;
+}
+
+// `value` is the argument as a JSON value
+QByteArray buildPayload(const ActionSpec& spec, const QByteArray& value) {
+    QByteArray payload(spec.prefix.data(), static_cast<qsizetype>(spec.prefix.size()));
+    if (spec.arg == ActionArg::None) return payload;
+    payload += value;
+    payload.append(spec.suffix.data(), static_cast<qsizetype>(spec.suffix.size()));
+    return payload;
+}
+
+QByteArray buildPayload(const ActionSpec& spec, std::optional<qint64> arg) {
+    return buildPayload(spec, arg ? QByteArray::number(*arg) : QByteArrayLiteral("null"));
+}
+
+// Parses a size the way niri's CLI does into its SizeChange enum: a trailing
+// '%' makes it a proportion (in percent) and a leading sign an adjustment
+std::optional<QByteArray> sizeChangeJson(const QString& text) {
+    QString value = text.trimmed();
+    const bool proportion = value.endsWith(u'%');
+    if (proportion) value.chop(1);
+    const bool adjust = value.startsWith(u'+') || value.startsWith(u'-');
+
+    bool ok = false;
+    QByteArray number;
+    if (proportion) {
+        const double v = value.toDouble(&ok);
+        ok = ok && std::isfinite(v);
+        number = QByteArray::number(v);
+    } else {
+        number = QByteArray::number(value.toInt(&ok));
+    }
+    if (!ok) return std::nullopt;
+
+    const QByteArray variant = proportion ? (adjust ? "AdjustProportion" : "SetProportion")
+                                          : (adjust ? "AdjustFixed" : "SetFixed");
+    return "{\"" + variant + "\":" + number + "}";
+}
+
+} // namespace
+
+bool NiriIpc::sendAction(std::string_view name, std::optional<qint64> arg) {
+    if (!m_available) return false;
+
+    const ActionSpec* spec = findAction(name);
+    if (!spec) return false;
+    if (!arg && (spec->arg == ActionArg::RequiredId || spec->arg == ActionArg::Number)) {
+        qWarning() << "NiriIpc: Action" << QByteArray(name.data(), static_cast<qsizetype>(name.size()))
+                   << "requires an argument";
+        return false;
+    }
+
+    m_requestSocket.action(buildPayload(*spec, arg));
+    return true;
+}
+
 bool NiriIpc::action(const QString& actionName, const QVariantList& args) {
     if (!m_available) return false;
 
+    const QByteArray name = actionName.toLatin1();
+    const ActionSpec* spec = findAction(std::string_view(name.constData(), static_cast<std::size_t>(name.size())));
+    if (spec) {
+        // Parse the CLI-style arguments the QML layer passes against the action's schema
+        std::optional<qint64> arg;
+        bool ok = true;
+        switch (spec->arg) {
+        case ActionArg::None:
+            ok = args.isEmpty();
+            break;
+        case ActionArg::OptionalId:
+            if (args.size() == 2 && args.at(0).toString() == QStringLiteral("--id")) {
+                arg = args.at(1).toLongLong(&ok);
+            } else {
+                ok = args.isEmpty();
+            }
+            break;
+        case ActionArg::RequiredId:
+            ok = args.size() == 2 && args.at(0).toString() == QStringLiteral("--id");
+            if (ok) arg = args.at(1).toLongLong(&ok);
+            break;
+        case ActionArg::OptionalDelay:
+            if (args.size() == 2 && args.at(0).toString() == QStringLiteral("-d")) {
+                arg = args.at(1).toLongLong(&ok);
+            } else {
+                ok = args.isEmpty();
+            }
+            break;
+        case ActionArg::Number:
+            ok = args.size() == 1;
+            if (ok) arg = args.at(0).toLongLong(&ok);
+            break;
+        case ActionArg::SizeChange:
+            if (const auto change = args.size() == 1 ? sizeChangeJson(args.at(0).toString()) : std::nullopt) {
+                m_requestSocket.action(buildPayload(*spec, *change));
+                return true;
+            }
+            ok = false;
+            break;
+        }
+
+        if (!ok) {
+            qWarning() << "NiriIpc: Unhandled action args for" << actionName << args;
+            return false;
+        }
+        m_requestSocket.action(buildPayload(*spec, arg));
+        return true;
+    }
+
+    // The schema of an unknown action isn't known, and guessing at it only
+    // produces payloads niri rejects, so only argument-less ones are sent
+    if (!args.isEmpty()) {
+        qWarning() << "NiriIpc: Unknown action" << actionName << "can't take args" << args;
+        return false;
+    }
+
     // Convert action name from kebab-case to PascalCase for IPC
     QString pascalName;
     bool capitalizeNext = true;
@@ -144,108 +333,70 @@ bool NiriIpc::action(const QString& actionName, const QVariantList& args) {
         }
     }
 
-    // Build the inner action object based on niri's expected JSON format.
-    // Each action has a specific schema; we match the patterns used by the QML layer.
     QJsonObject actionObj;
-    QJsonValue innerValue;
-
-    if (args.size() >= 2 && args.at(0).toString() == QStringLiteral("--id")) {
-        // Actions with --id: FocusWindow, CloseWindow, ToggleWindowFloating
-        // Format: {"ActionName": {"id": N}}
-        QJsonObject inner;
-        inner[QStringLiteral("id")] = args.at(1).toLongLong();
-        innerValue = inner;
-    } else if (args.size() == 2 && args.at(0).toString() == QStringLiteral("-d")) {
-        // DoScreenTransition with delay: {"DoScreenTransition": {"delay_ms": N}}
-        QJsonObject inner;
-        inner[QStringLiteral("delay_ms")] = args.at(1).toInt();
-        innerValue = inner;
-    } else if (args.isEmpty()) {
-        // No-arg actions.
-        // Most accept {} but some need specific defaults.
-        if (pascalName == QStringLiteral("ScreenshotWindow")) {
-            QJsonObject inner;
-            inner[QStringLiteral("id")] = QJsonValue::Null;
-            inner[QStringLiteral("write_to_disk")] = true;
-            inner[QStringLiteral("path")] = QJsonValue::Null;
-            innerValue = inner;
-        } else if (pascalName == QStringLiteral("CloseWindow") ||
-                   pascalName == QStringLiteral("ToggleWindowFloating")) {
-            QJsonObject inner;
-            inner[QStringLiteral("id")] = QJsonValue::Null;
-            innerValue = inner;
-        } else {
-            innerValue = QJsonObject();
-        }
-    } else if (args.size() == 1) {
-        // Single positional arg — meaning depends on the action.
-        bool isNumber = false;
-        const qint64 num = args.at(0).toLongLong(&isNumber);
-
-        if (pascalName == QStringLiteral("FocusWorkspace")) {
-            // {"FocusWorkspace": {"reference": {"Index": N}}}
-            QJsonObject ref;
-            ref[QStringLiteral("Index")] = num;
-            QJsonObject inner;
-            inner[QStringLiteral("reference")] = ref;
-            innerValue = inner;
-        } else if (pascalName == QStringLiteral("MoveWindowToWorkspace")) {
-            // {"MoveWindowToWorkspace": {"window_id": null, "reference": {"Index": N}, "focus": true}}
-            QJsonObject ref;
-            ref[QStringLiteral("Index")] = num;
-            QJsonObject inner;
-            inner[QStringLiteral("window_id")] = QJsonValue::Null;
-            inner[QStringLiteral("reference")] = ref;
-            inner[QStringLiteral("focus")] = true;
-            innerValue = inner;
-        } else if (pascalName == QStringLiteral("MoveColumnToIndex")) {
-            // {"MoveColumnToIndex": {"index": N}}
-            QJsonObject inner;
-            inner[QStringLiteral("index")] = num;
-            innerValue = inner;
-        } else if (isNumber) {
-            // Generic numeric arg — wrap as object with reasonable key
-            QJsonObject inner;
-            inner[QStringLiteral("id")] = num;
-            innerValue = inner;
-        } else {
-            // String argument
-            innerValue = args.at(0).toString();
-        }
-    } else {
-        qWarning() << "NiriIpc: Unhandled action args for" << actionName << args;
-        innerValue = QJsonObject();
-    }
-
-    actionObj[pascalName] = innerValue;
+    actionObj[pascalName] = QJsonObject();
 
     QJsonObject wrapper;
     wrapper[QStringLiteral("Action")] = actionObj;
-    const QByteArray payload = QJsonDocument(wrapper).toJson(QJsonDocument::Compact);
-
-    m_requestSocket.action(payload);
+    m_requestSocket.action(QJsonDocument(wrapper).toJson(QJsonDocument::Compact));
     return true;
 }
 
+bool NiriIpc::focusWorkspace(int index) {
+    return sendAction("focus-workspace", index);
+}
+
+bool NiriIpc::moveWindowToWorkspace(int index) {
+    return sendAction("move-window-to-workspace", index);
+}
+
+bool NiriIpc::focusWindow(qint64 id) {
+    return sendAction("focus-window", id);
+}
+
+bool NiriIpc::closeWindow(qint64 id) {
+    return sendAction("close-window", id >= 0 ? std::optional<qint64>(id) : std::nullopt);
+}
+
+bool NiriIpc::toggleWindowFloating(qint64 id) {
+    return sendAction("toggle-window-floating", id >= 0 ? std::optional<qint64>(id) : std::nullopt);
+}
+
+bool NiriIpc::moveColumnToIndex(int index) {
+    return sendAction("move-column-to-index", index);
+}
+
+bool NiriIpc::doScreenTransition(int delayMs) {
+    return sendAction("do-screen-transition", delayMs >= 0 ? std::optional<qint64>(delayMs) : std::nullopt);
+}
+
 int NiriIpc::getWorkspaceIdxById(int workspaceId) const {
-    const auto& wsList = m_workspacesModel->items();
-    for (const auto& v : wsList) {
-        const auto ws = v.toMap();
-        if (ws.value(QStringLiteral("id")).toInt() == workspaceId) {
-            return ws.value(QStringLiteral("idx")).toInt();
+    for (const auto& ws : m_workspacesModel->items()) {
+        if (ws.id == workspaceId) {
+            return ws.idx;
         }
     }
     return -1;
 }
 
 QVariantList NiriIpc::getWindowsByWorkspaceId(int wsId) const {
+    const auto it = m_windowsByWorkspace.constFind(wsId);
+    if (it == m_windowsByWorkspace.constEnd()) return {};
+
+    // Only this workspace's windows are touched; keep them in model order
+    QList<int> rows;
+    rows.reserve(it->size());
+    for (const qint64 id : *it) {
+        const int row = findWindowIndexById(id);
+        if (row >= 0) rows.append(row);
+    }
+    std::sort(rows.begin(), rows.end());
+
+    const auto& winList = m_windowsModel->items();
     QVariantList res;
-    const auto& wins = m_windowsModel->items();
-    for (const auto& w : wins) {
-        auto map = w.toMap();
-        if (map.value(QStringLiteral("workspace_id")).toInt() == wsId) {
-            res.append(w);
-        }
+    res.reserve(rows.size());
+    for (const int row : rows) {
+        res.append(winList.at(row).toVariantMap());
     }
     return res;
 }
@@ -253,8 +404,7 @@ QVariantList NiriIpc::getWindowsByWorkspaceId(int wsId) const {
 QVariantList NiriIpc::getWindowsByWorkspaceIndex(int index) const {
     const auto& wsList = m_workspacesModel->items();
     if (index < 0 || index >= wsList.size()) return {};
-    int wsId = wsList.at(index).toMap().value(QStringLiteral("id")).toInt();
-    return getWindowsByWorkspaceId(wsId);
+    return getWindowsByWorkspaceId(static_cast<int>(wsList.at(index).id));
 }
 
 QVariantList NiriIpc::getActiveWorkspaceWindows() const {
@@ -262,6 +412,14 @@ QVariantList NiriIpc::getActiveWorkspaceWindows() const {
     return getWindowsByWorkspaceId(m_focusedWorkspaceId);
 }
 
+QAbstractItemModel* NiriIpc::workspaceWindowsModel(int wsId) {
+    auto it = m_workspaceWindowsModels.find(wsId);
+    if (it == m_workspaceWindowsModels.end()) {
+        it = m_workspaceWindowsModels.insert(wsId, new NiriWorkspaceWindowsModel(m_windowsModel, wsId, this));
+    }
+    return it.value();
+}
+
 // ── Event Stream Slots ───────────────────────────────────────────────
 
 void NiriIpc::onEventStreamConnected() {
@@ -277,56 +435,81 @@ void NiriIpc::onEventStreamDisconnected() {
     emit availableChanged();
 }
 
-void NiriIpc::onEvent(const QJsonObject& event) {
-    if (event.contains(QStringLiteral("WorkspacesChanged"))) {
-        handleWorkspacesChanged(event.value(QStringLiteral("WorkspacesChanged")).toObject());
-    } else if (event.contains(QStringLiteral("WorkspaceActivated"))) {
+/// Positions the reader on the value of `field` inside the next object.
+static bool enterField(NiriJsonReader& reader, std::string_view field) {
+    if (!reader.enterObject()) return false;
+    std::string_view key;
+    while (reader.nextKey(key)) {
+        if (key == field) return true;
+        if (!reader.skipValue()) return false;
+    }
+    return false;
+}
+
+void NiriIpc::onEvent(const QByteArray& line) {
+    // Dispatch on the event type and decode hot events straight into the typed
+    // store; only rare events are handed to QJsonDocument
+    NiriJsonReader reader(std::string_view(line.constData(), static_cast<std::size_t>(line.size())));
+    std::string_view type;
+    if (!reader.enterObject() || !reader.nextKey(type)) {
+        qWarning() << "NiriIpc: Malformed event:" << line;
+        return;
+    }
+
+    bool ok = true;
+    if (type == "WindowLayoutsChanged") {
+        QList<std::pair<qint64, NiriWindowLayout>> changes;
+        ok = enterField(reader, "changes") && readNiriLayoutChanges(reader, changes);
+        if (ok) applyWindowLayoutsChanged(changes);
+    } else if (type == "WindowOpenedOrChanged") {
+        NiriWindow window;
+        ok = enterField(reader, "window") && readNiriWindow(reader, window);
+        if (ok) applyWindowOpenedOrChanged(window);
+    } else if (type == "WindowFocusChanged") {
+        ok = enterField(reader, "id");
+        const qint64 id = reader.readOptionalInt();
+        ok = ok && !reader.hasError();
+        if (ok) applyWindowFocusChanged(id);
+    } else if (type == "WindowClosed") {
+        ok = enterField(reader, "id");
+        const qint64 id = reader.readOptionalInt();
+        ok = ok && !reader.hasError();
+        if (ok) applyWindowClosed(id);
+    } else if (type == "WorkspaceActivated") {
         // WorkspaceActivated is handled within WorkspacesChanged in the new protocol
         // but may still arrive separately - handle it
-        const auto data = event.value(QStringLiteral("WorkspaceActivated")).toObject();
-        const int id = data.value(QStringLiteral("id")).toInt();
-        const bool focused = data.value(QStringLiteral("focused")).toBool();
-        Q_UNUSED(focused);
-        m_focusedWorkspaceId = id;
-        
-        QVariantList currentWs = m_workspacesModel->items();
-        for (int i = 0; i < currentWs.size(); ++i) {
-            auto ws = currentWs.at(i).toMap();
-            if (ws.value(QStringLiteral("id")).toInt() == id) {
-                m_focusedWorkspaceIndex = i;
-                m_focusedMonitorName = ws.value(QStringLiteral("output")).toString();
-                // Update active/focused flags on same output
-                const QString output = m_focusedMonitorName;
-                for (int j = 0; j < currentWs.size(); ++j) {
-                    auto w = currentWs.at(j).toMap();
-                    if (w.value(QStringLiteral("output")).toString() == output) {
-                        w[QStringLiteral("is_active")] = (j == i);
-                        w[QStringLiteral("is_focused")] = (j == i);
-                        currentWs[j] = w;
-                        m_workspacesModel->setItem(j, w);
-                    }
-                }
-                break;
+        ok = enterField(reader, "id");
+        const qint64 id = reader.readOptionalInt();
+        ok = ok && !reader.hasError();
+        if (ok) applyWorkspaceActivated(id);
+    } else if (type == "WindowsChanged") {
+        QList<NiriWindow> windows;
+        ok = enterField(reader, "windows") && readNiriWindowList(reader, windows);
+        if (ok) applyWindowsChanged(windows);
+    } else if (type == "WorkspacesChanged") {
+        QList<NiriWorkspace> workspaces;
+        ok = enterField(reader, "workspaces") && readNiriWorkspaceList(reader, workspaces);
+        if (ok) applyWorkspacesChanged(workspaces);
+    } else if (type == "KeyboardLayoutsChanged" || type == "OverviewOpenedOrClosed" || type == "OutputsChanged") {
+        const std::string handled(type);
+        const std::string_view raw = reader.rawValue();
+        ok = !reader.hasError();
+        if (ok) {
+            const QJsonObject data =
+                QJsonDocument::fromJson(QByteArray::fromRawData(raw.data(), static_cast<qsizetype>(raw.size())))
+                    .object();
+            if (handled == "KeyboardLayoutsChanged") {
+                handleKeyboardLayoutsChanged(data);
+            } else if (handled == "OverviewOpenedOrClosed") {
+                handleOverviewOpenedOrClosed(data);
+            } else {
+                handleOutputsChanged(data);
             }
         }
-        updateCurrentOutputWorkspaces();
-        emit focusedWorkspaceChanged();
-    } else if (event.contains(QStringLiteral("WindowsChanged"))) {
-        handleWindowsChanged(event.value(QStringLiteral("WindowsChanged")).toObject());
-    } else if (event.contains(QStringLiteral("WindowOpenedOrChanged"))) {
-        handleWindowOpenedOrChanged(event.value(QStringLiteral("WindowOpenedOrChanged")).toObject());
-    } else if (event.contains(QStringLiteral("WindowClosed"))) {
-        handleWindowClosed(event.value(QStringLiteral("WindowClosed")).toObject());
-    } else if (event.contains(QStringLiteral("WindowFocusChanged"))) {
-        handleWindowFocusChanged(event.value(QStringLiteral("WindowFocusChanged")).toObject());
-    } else if (event.contains(QStringLiteral("WindowLayoutsChanged"))) {
-        handleWindowLayoutsChanged(event.value(QStringLiteral("WindowLayoutsChanged")).toObject());
-    } else if (event.contains(QStringLiteral("KeyboardLayoutsChanged"))) {
-        handleKeyboardLayoutsChanged(event.value(QStringLiteral("KeyboardLayoutsChanged")).toObject());
-    } else if (event.contains(QStringLiteral("OverviewOpenedOrClosed"))) {
-        handleOverviewOpenedOrClosed(event.value(QStringLiteral("OverviewOpenedOrClosed")).toObject());
-    } else if (event.contains(QStringLiteral("OutputsChanged"))) {
-        handleOutputsChanged(event.value(QStringLiteral("OutputsChanged")).toObject());
+    }
+
+    if (!ok) {
+        qWarning() << "NiriIpc: Failed to decode event:" << line;
     }
 }
 
@@ -335,28 +518,31 @@ void NiriIpc::onEvent(const QJsonObject& event) {
 void NiriIpc::fetchInitialState() {
     // Initial query responses have PascalCase keys wrapping the data:
     //   {"Ok":{"Workspaces":[...]}}  -> result = {"Workspaces":[...]}
-    // But event handlers expect lowercase keys matching the event format:
-    //   {"WorkspacesChanged":{"workspaces":[...]}}
-    // So we must unwrap the PascalCase key and re-wrap with the event format.
+    // Typed state is decoded from the unwrapped payload and applied the same way as events;
+    // keyboard layouts are re-wrapped into the event format instead.
 
     // Fetch workspaces
     m_requestSocket.request("\"Workspaces\"", [this](bool ok, const QJsonObject& resp) {
         if (!ok) return;
         const auto result = resp.value(QStringLiteral("result")).toObject();
-        // result = {"Workspaces": [...]} -> unwrap to event format {"workspaces": [...]}
-        QJsonObject data;
-        data[QStringLiteral("workspaces")] = result.value(QStringLiteral("Workspaces"));
-        handleWorkspacesChanged(data);
+        // result = {"Workspaces": [...]}
+        QList<NiriWorkspace> workspaces;
+        for (const auto& v : result.value(QStringLiteral("Workspaces")).toArray()) {
+            workspaces.append(NiriWorkspace::fromJson(v.toObject()));
+        }
+        applyWorkspacesChanged(workspaces);
     });
 
     // Fetch windows
     m_requestSocket.request("\"Windows\"", [this](bool ok, const QJsonObject& resp) {
         if (!ok) return;
         const auto result = resp.value(QStringLiteral("result")).toObject();
-        // result = {"Windows": [...]} -> {"windows": [...]}
-        QJsonObject data;
-        data[QStringLiteral("windows")] = result.value(QStringLiteral("Windows"));
-        handleWindowsChanged(data);
+        // result = {"Windows": [...]}
+        QList<NiriWindow> windows;
+        for (const auto& v : result.value(QStringLiteral("Windows")).toArray()) {
+            windows.append(NiriWindow::fromJson(v.toObject()));
+        }
+        applyWindowsChanged(windows);
     });
 
     // Fetch focused window
@@ -366,9 +552,7 @@ void NiriIpc::fetchInitialState() {
         // result = {"FocusedWindow": {id, title, ...}} or {"FocusedWindow": null}
         const auto win = result.value(QStringLiteral("FocusedWindow"));
         if (win.isObject()) {
-            QJsonObject d;
-            d[QStringLiteral("id")] = win.toObject().value(QStringLiteral("id"));
-            handleWindowFocusChanged(d);
+            applyWindowFocusChanged(win.toObject().value(QStringLiteral("id")).toInteger(-1));
         }
     });
 
@@ -396,166 +580,167 @@ void NiriIpc::fetchInitialState() {
 
 // ── Event Handlers ───────────────────────────────────────────────────
 
-static QVariantMap jsonObjectToVariantMap(const QJsonObject& obj) {
-    return obj.toVariantMap();
-}
-
 static QVariantList jsonArrayToVariantList(const QJsonArray& arr) {
     return arr.toVariantList();
 }
 
-void NiriIpc::handleWorkspacesChanged(const QJsonObject& data) {
-    const QJsonArray wsArray = data.value(QStringLiteral("workspaces")).toArray();
-
-    QVariantList wsList = jsonArrayToVariantList(wsArray);
+static bool windowLessThan(const NiriWindow& a, const NiriWindow& b) {
+    if (a.layout.column != b.layout.column) return a.layout.column < b.layout.column;
+    return a.layout.row < b.layout.row;
+}
 
-    // Sort by idx
-    std::sort(wsList.begin(), wsList.end(), [](const QVariant& a, const QVariant& b) {
-        return a.toMap().value(QStringLiteral("idx")).toInt()
-             < b.toMap().value(QStringLiteral("idx")).toInt();
+void NiriIpc::applyWorkspacesChanged(const QList<NiriWorkspace>& workspaceList) {
+    // Diff against the current rows, then keep them sorted by idx
+    m_workspacesModel->replaceAll(workspaceList);
+    m_workspacesModel->sortItems([](const NiriWorkspace& a, const NiriWorkspace& b) {
+        return a.idx < b.idx;
     });
+    invalidateWorkspacesView();
 
-    m_workspacesModel->resetData(wsList);
+    for (auto it = m_workspaceWindowsModels.begin(); it != m_workspaceWindowsModels.end();) {
+        if (m_workspacesModel->indexOfId(it.key()) < 0) {
+            it.value()->deleteLater();
+            it = m_workspaceWindowsModels.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
     // Find focused workspace
+    const auto& workspaces = m_workspacesModel->items();
     m_focusedWorkspaceIndex = -1;
     m_focusedWorkspaceId = -1;
-    for (int i = 0; i < wsList.size(); ++i) {
-        const auto ws = wsList.at(i).toMap();
-        if (ws.value(QStringLiteral("is_focused")).toBool()) {
+    for (int i = 0; i < workspaces.size(); ++i) {
+        const auto& ws = workspaces.at(i);
+        if (ws.isFocused) {
             m_focusedWorkspaceIndex = i;
-            m_focusedWorkspaceId = ws.value(QStringLiteral("id")).toInt();
-            m_focusedMonitorName = ws.value(QStringLiteral("output")).toString();
+            m_focusedWorkspaceId = static_cast<int>(ws.id);
+            m_focusedMonitorName = ws.output;
             break;
         }
     }
 
-    if (m_focusedWorkspaceIndex < 0 && !wsList.isEmpty()) {
+    if (m_focusedWorkspaceIndex < 0 && !workspaces.isEmpty()) {
         m_focusedWorkspaceIndex = 0;
     }
 
-    updateCurrentOutputWorkspaces();
-    updateWorkspaceHasWindows();
-    emit workspacesChanged();
-    emit focusedWorkspaceChanged();
+    markPending(CurrentOutputWorkspacesPending | WorkspaceHasWindowsPending | WorkspacesPending |
+                FocusedWorkspacePending);
 }
 
-void NiriIpc::handleWindowsChanged(const QJsonObject& data) {
-    const QJsonArray winArray = data.value(QStringLiteral("windows")).toArray();
-    QVariantList winList = jsonArrayToVariantList(winArray);
-
-    // Ensure all windows have a layout object
-    for (int i = 0; i < winList.size(); ++i) {
-        auto w = winList.at(i).toMap();
-        if (!w.contains(QStringLiteral("layout"))) {
-            w[QStringLiteral("layout")] = QVariantMap();
-            winList[i] = w;
-        }
-    }
-
-    m_windowsModel->resetData(winList);
+void NiriIpc::applyWindowsChanged(const QList<NiriWindow>& windowList) {
+    m_windowsModel->replaceAll(windowList);
 
     sortWindowsList();
     rebuildWindowIndex();
-    updateFocusedWindowFields();
-    updateWorkspaceHasWindows();
-    emit windowsChanged();
-}
+    rebuildWorkspaceWindowIndex();
+    invalidateWindowsView();
 
-void NiriIpc::handleWindowOpenedOrChanged(const QJsonObject& data) {
-    const QJsonObject winObj = data.value(QStringLiteral("window")).toObject();
-    if (winObj.isEmpty()) return;
+    // Rows shift as windows come and go, so the focused one is re-found on flush
+    markPending(FocusedWindowPending | WorkspaceHasWindowsPending | WindowsPending);
+}
 
-    const QVariantMap window = jsonObjectToVariantMap(winObj);
-    const qint64 winId = window.value(QStringLiteral("id")).toLongLong();
+void NiriIpc::applyWindowOpenedOrChanged(const NiriWindow& window) {
+    if (window.id < 0) return;
 
+    // The event always carries the complete window, so it replaces the stored one
     // O(1) lookup via hash index
-    const int existingIdx = findWindowIndexById(winId);
+    const int existingIdx = findWindowIndexById(window.id);
 
     if (existingIdx >= 0) {
-        // Merge updated fields into existing
-        auto existing = m_windowsModel->items().at(existingIdx).toMap();
-        for (auto it = window.begin(); it != window.end(); ++it) {
-            existing[it.key()] = it.value();
+        const NiriWindow& old = m_windowsModel->items().at(existingIdx);
+        const bool moved = old.layout != window.layout;
+        indexWindowWorkspace(window.id, old.workspaceId, window.workspaceId);
+        m_windowsModel->setItem(existingIdx, window);
+        if (moved) {
+            sortWindowsList();
+            rebuildWindowIndex();
         }
-        m_windowsModel->setItem(existingIdx, existing);
     } else {
-        m_windowsModel->appendItem(window);
+        // Insert straight into its sorted position
+        const auto& winList = m_windowsModel->items();
+        const auto it = std::upper_bound(winList.begin(), winList.end(), window, windowLessThan);
+        m_windowsModel->insertItem(static_cast<int>(it - winList.begin()), window);
+        rebuildWindowIndex();
+        indexWindowWorkspace(window.id, -1, window.workspaceId);
     }
 
-    sortWindowsList();
-    rebuildWindowIndex();
+    invalidateWindowsView();
 
-    if (window.value(QStringLiteral("is_focused")).toBool()) {
-        m_focusedWindowId = QString::number(winId);
-        m_focusedWindowIndex = findWindowIndexById(winId);
+    if (window.isFocused) {
+        m_focusedWindowId = QString::number(window.id);
     }
 
-    updateFocusedWindowFields();
-    updateWorkspaceHasWindows();
-    emit windowsChanged();
-    emit windowOpenedOrChanged(window);
+    markPending(FocusedWindowPending | WorkspaceHasWindowsPending | WindowsPending);
+    emit windowOpenedOrChanged(window.toVariantMap());
 }
 
-void NiriIpc::handleWindowClosed(const QJsonObject& data) {
-    const qint64 closedId = data.value(QStringLiteral("id")).toInteger();
-
+void NiriIpc::applyWindowClosed(qint64 closedId) {
     // O(1) lookup via hash
     const int idx = findWindowIndexById(closedId);
     if (idx >= 0) {
+        indexWindowWorkspace(closedId, m_windowsModel->items().at(idx).workspaceId, -1);
         m_windowsModel->removeItem(idx);
         rebuildWindowIndex();
+        invalidateWindowsView();
     }
 
-    updateFocusedWindowFields();
-    updateWorkspaceHasWindows();
-    emit windowsChanged();
+    markPending(FocusedWindowPending | WorkspaceHasWindowsPending | WindowsPending);
 }
 
-void NiriIpc::handleWindowFocusChanged(const QJsonObject& data) {
-    if (data.contains(QStringLiteral("id")) && !data.value(QStringLiteral("id")).isNull()) {
-        const qint64 id = data.value(QStringLiteral("id")).toInteger();
+void NiriIpc::applyWindowFocusChanged(qint64 id) {
+    if (id >= 0) {
         m_focusedWindowId = QString::number(id);
-        m_focusedWindowIndex = findWindowIndexById(id);
     } else {
         m_focusedWindowId.clear();
-        m_focusedWindowIndex = -1;
     }
 
-    updateFocusedWindowFields();
-    emit focusedWindowChanged();
+    markPending(FocusedWindowPending);
 }
 
-void NiriIpc::handleWindowLayoutsChanged(const QJsonObject& data) {
-    const QJsonArray changes = data.value(QStringLiteral("changes")).toArray();
+void NiriIpc::applyWindowLayoutsChanged(const QList<std::pair<qint64, NiriWindowLayout>>& changes) {
     if (changes.isEmpty()) return;
 
-    for (const auto& change : changes) {
-        const QJsonArray pair = change.toArray();
-        if (pair.size() != 2) continue;
-
-        const qint64 id = pair.at(0).toInteger();
-        const auto layout = pair.at(1).toObject().toVariantMap();
-
+    for (const auto& [id, layout] : changes) {
         // O(1) lookup via hash index
         const int idx = findWindowIndexById(id);
         if (idx >= 0) {
-            auto w = m_windowsModel->items().at(idx).toMap();
-            w[QStringLiteral("layout")] = layout;
+            NiriWindow w = m_windowsModel->items().at(idx);
+            w.layout = layout;
             m_windowsModel->setItem(idx, w);
         }
     }
 
     sortWindowsList();
     rebuildWindowIndex();
+    invalidateWindowsView();
 
-    // Re-find focused index after sort via hash
-    if (!m_focusedWindowId.isEmpty()) {
-        m_focusedWindowIndex = findWindowIndexById(m_focusedWindowId.toLongLong());
-    }
+    markPending(FocusedWindowPending | WindowsPending);
+}
 
-    updateFocusedWindowFields();
-    emit windowsChanged();
+void NiriIpc::applyWorkspaceActivated(qint64 id) {
+    m_focusedWorkspaceId = static_cast<int>(id);
+
+    const auto& currentWs = m_workspacesModel->items();
+    for (int i = 0; i < currentWs.size(); ++i) {
+        if (currentWs.at(i).id != id) continue;
+
+        m_focusedWorkspaceIndex = i;
+        m_focusedMonitorName = currentWs.at(i).output;
+        // Update active/focused flags on same output
+        for (int j = 0; j < currentWs.size(); ++j) {
+            if (currentWs.at(j).output != m_focusedMonitorName) continue;
+            NiriWorkspace w = currentWs.at(j);
+            w.isActive = (j == i);
+            w.isFocused = (j == i);
+            if (w != currentWs.at(j)) {
+                m_workspacesModel->setItem(j, w);
+            }
+        }
+        break;
+    }
+    invalidateWorkspacesView();
+    markPending(CurrentOutputWorkspacesPending | FocusedWorkspacePending);
 }
 
 void NiriIpc::handleOutputsChanged(const QJsonObject& data) {
@@ -619,36 +804,48 @@ void NiriIpc::handleOverviewOpenedOrClosed(const QJsonObject& data) {
 
 // ── Internal Helpers ─────────────────────────────────────────────────
 
-void NiriIpc::updateCurrentOutputWorkspaces() {
-    if (m_focusedMonitorName.isEmpty()) {
-        m_currentOutputWorkspaces = m_workspacesModel->items();
-        return;
+void NiriIpc::markPending(quint32 changes) {
+    m_pending |= changes;
+    if (!m_coalesceEvents) {
+        flushPending();
+    } else if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void NiriIpc::flushPending() {
+    const quint32 pending = std::exchange(m_pending, 0);
+    if (pending == 0) return;
+
+    if (pending & CurrentOutputWorkspacesPending) updateCurrentOutputWorkspaces();
+    if (pending & WorkspaceHasWindowsPending) updateWorkspaceHasWindows();
+    if (pending & FocusedWindowPending) {
+        // Rows may have moved since the focus event, so resolve the index now
+        m_focusedWindowIndex = m_focusedWindowId.isEmpty() ? -1 : findWindowIndexById(m_focusedWindowId.toLongLong());
+        updateFocusedWindowFields();
     }
 
+    if (pending & WorkspacesPending) emit workspacesChanged();
+    if (pending & FocusedWorkspacePending) emit focusedWorkspaceChanged();
+    if (pending & WindowsPending) emit windowsChanged();
+}
+
+void NiriIpc::updateCurrentOutputWorkspaces() {
     m_currentOutputWorkspaces.clear();
-    const auto& wsList = m_workspacesModel->items();
-    for (const auto& v : wsList) {
-        if (v.toMap().value(QStringLiteral("output")).toString() == m_focusedMonitorName) {
-            m_currentOutputWorkspaces.append(v);
+    for (const auto& ws : m_workspacesModel->items()) {
+        if (m_focusedMonitorName.isEmpty() || ws.output == m_focusedMonitorName) {
+            m_currentOutputWorkspaces.append(ws.toVariantMap());
         }
     }
 }
 
 void NiriIpc::updateWorkspaceHasWindows() {
     QVariantMap newState;
-    const auto& wsList = m_workspacesModel->items();
-    for (const auto& wsV : wsList) {
-        const auto ws = wsV.toMap();
-        newState[QString::number(ws.value(QStringLiteral("idx")).toInt())] = false;
-    }
-
-    const auto& winList = m_windowsModel->items();
-    for (const auto& winV : winList) {
-        const auto win = winV.toMap();
-        const int wsId = win.value(QStringLiteral("workspace_id")).toInt();
-        const int idx = getWorkspaceIdxById(wsId);
-        if (idx >= 0) {
-            newState[QString::number(idx)] = true;
+    for (const auto& ws : m_workspacesModel->items()) {
+        const QString key = QString::number(ws.idx);
+        // Workspaces can share an idx across outputs, so any occupied one wins
+        if (!newState.value(key).toBool()) {
+            newState[key] = m_windowsByWorkspace.contains(ws.id);
         }
     }
 
@@ -661,21 +858,19 @@ void NiriIpc::updateWorkspaceHasWindows() {
 void NiriIpc::updateFocusedWindowFields() {
     const auto& winList = m_windowsModel->items();
     if (m_focusedWindowIndex >= 0 && m_focusedWindowIndex < winList.size()) {
-        const auto win = winList.at(m_focusedWindowIndex).toMap();
-        QString title = win.value(QStringLiteral("title")).toString();
+        const auto& win = winList.at(m_focusedWindowIndex);
+        QString title = win.title;
         // Clean non-printable prefix characters
         while (!title.isEmpty() && title.at(0).unicode() < 0x20) {
             title.remove(0, 1);
         }
         m_focusedWindowTitle = title.isEmpty() ? QStringLiteral("(Unnamed window)") : title;
-        m_focusedWindowClass = win.value(QStringLiteral("app_id")).toString();
-        m_focusedWindow = win;
+        m_focusedWindowClass = win.appId;
+        m_focusedWindow = win.toVariantMap();
 
         // Track scroll direction
-        const auto layout = win.value(QStringLiteral("layout")).toMap();
-        const auto pos = layout.value(QStringLiteral("pos_in_scrolling_layout")).toList();
-        if (pos.size() >= 2) {
-            const int currentCol = pos.at(0).toInt();
+        if (win.layout.hasScrollingPos) {
+            const int currentCol = win.layout.column;
             if (m_lastFocusedColumn >= 0) {
                 const QString newDir = currentCol > m_lastFocusedColumn ? QStringLiteral("right")
                                      : currentCol < m_lastFocusedColumn ? QStringLiteral("left")
@@ -688,7 +883,7 @@ void NiriIpc::updateFocusedWindowFields() {
             m_lastFocusedColumn = currentCol;
         }
 
-        m_lastFocusedWindow = win;
+        m_lastFocusedWindow = m_focusedWindow;
         emit lastFocusedWindowChanged();
     } else {
         m_focusedWindowTitle.clear();
@@ -699,20 +894,7 @@ void NiriIpc::updateFocusedWindowFields() {
 }
 
 void NiriIpc::sortWindowsList() {
-    QVariantList winList = m_windowsModel->items();
-    std::sort(winList.begin(), winList.end(), [](const QVariant& a, const QVariant& b) {
-        const auto aLayout = a.toMap().value(QStringLiteral("layout")).toMap();
-        const auto bLayout = b.toMap().value(QStringLiteral("layout")).toMap();
-        const auto aPos = aLayout.value(QStringLiteral("pos_in_scrolling_layout")).toList();
-        const auto bPos = bLayout.value(QStringLiteral("pos_in_scrolling_layout")).toList();
-        const int ax = aPos.size() >= 1 ? aPos.at(0).toInt() : 0;
-        const int ay = aPos.size() >= 2 ? aPos.at(1).toInt() : 0;
-        const int bx = bPos.size() >= 1 ? bPos.at(0).toInt() : 0;
-        const int by = bPos.size() >= 2 ? bPos.at(1).toInt() : 0;
-        if (ax != bx) return ax < bx;
-        return ay < by;
-    });
-    m_windowsModel->resetData(winList);
+    m_windowsModel->sortItems(windowLessThan);
 }
 
 void NiriIpc::rebuildWindowIndex() {
@@ -720,17 +902,75 @@ void NiriIpc::rebuildWindowIndex() {
     const auto& winList = m_windowsModel->items();
     m_windowIndex.reserve(winList.size());
     for (int i = 0; i < winList.size(); ++i) {
-        const qint64 id = winList.at(i).toMap().value(QStringLiteral("id")).toLongLong();
-        m_windowIndex.insert(id, i);
+        m_windowIndex.insert(winList.at(i).id, i);
     }
 }
 
+void NiriIpc::invalidateWindowsView() {
+    m_windowsViewDirty = true;
+}
+
+void NiriIpc::invalidateWorkspacesView() {
+    m_workspacesViewDirty = true;
+}
+
 int NiriIpc::findWindowIndexById(qint64 id) const {
     auto it = m_windowIndex.find(id);
     return (it != m_windowIndex.end()) ? it.value() : -1;
 }
 
-// ── LED Watchers (capslock/numlock via /sys/class/leds) ──────────────
+void NiriIpc::indexWindowWorkspace(qint64 windowId, qint64 oldWorkspaceId, qint64 newWorkspaceId) {
+    if (oldWorkspaceId == newWorkspaceId) return;
+
+    if (oldWorkspaceId >= 0) {
+        const auto it = m_windowsByWorkspace.find(oldWorkspaceId);
+        if (it != m_windowsByWorkspace.end()) {
+            it->removeOne(windowId);
+            if (it->isEmpty()) m_windowsByWorkspace.erase(it);
+        }
+    }
+    if (newWorkspaceId >= 0) {
+        m_windowsByWorkspace[newWorkspaceId].append(windowId);
+    }
+}
+
+void NiriIpc::rebuildWorkspaceWindowIndex() {
+    m_windowsByWorkspace.clear();
+    for (const auto& win : m_windowsModel->items()) {
+        if (win.workspaceId >= 0) m_windowsByWorkspace[win.workspaceId].append(win.id);
+    }
+}
+
+// ── LED Watchers (capslock/numlock via evdev, /sys/class/leds fallback) ──
+
+/// Maps /sys/class/leds/<led>/brightness to the evdev node of the keyboard
+/// owning the LED, e.g. /dev/input/event3. Empty if it can't be resolved.
+static QString ledEventDevicePath(const QString& brightnessPath) {
+    const QDir deviceDir(QFileInfo(brightnessPath).dir().filePath(QStringLiteral("device")));
+    const auto events = deviceDir.entryList({ QStringLiteral("event*") }, QDir::Dirs | QDir::NoDotAndDotDot);
+    if (events.isEmpty()) return {};
+    return QStringLiteral("/dev/input/") + events.first();
+}
+
+/// Opens a keyboard's evdev node so that only EV_LED events are delivered.
+/// Unmasked, it also reports every key press, release and repeat. Returns -1
+/// if it can't be opened or the kernel predates EVIOCSMASK.
+static int openLedEventDevice(const QString& path) {
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    // A mask for EV_SYN selects event types rather than codes; EV_CNT bits fit in one word
+    unsigned long types = 1UL << EV_LED;
+    input_mask mask{};
+    mask.type = EV_SYN;
+    mask.codes_size = sizeof(types);
+    mask.codes_ptr = static_cast<__u64>(reinterpret_cast<std::uintptr_t>(&types));
+    if (::ioctl(fd, EVIOCSMASK, &mask) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
 
 void NiriIpc::setupLedWatchers() {
     QDir ledsDir(QStringLiteral("/sys/class/leds"));
@@ -751,12 +991,87 @@ void NiriIpc::setupLedWatchers() {
     // Initial read
     readLedState();
 
-    // Poll sysfs since inotify doesn't work on virtual files
-    if (!m_capsLockPath.isEmpty() || !m_numLockPath.isEmpty()) {
-        m_ledPollTimer.setInterval(1000);
-        connect(&m_ledPollTimer, &QTimer::timeout, this, &NiriIpc::readLedState);
-        m_ledPollTimer.start();
+    if (m_capsLockPath.isEmpty() && m_numLockPath.isEmpty()) return;
+
+    // The keyboard's evdev node reports EV_LED as soon as an LED toggles, and
+    // once masked to EV_LED it is silent otherwise. It usually needs the input
+    // group, so poll sysfs if any LED can't be watched that way (inotify
+    // doesn't work on sysfs attributes).
+    QStringList devices;
+    for (const auto& path : { m_capsLockPath, m_numLockPath }) {
+        if (path.isEmpty()) continue;
+        const QString device = ledEventDevicePath(path);
+        if (device.isEmpty()) {
+            devices.clear();
+            break;
+        }
+        if (!devices.contains(device)) devices.append(device);
+    }
+
+    bool watching = !devices.isEmpty();
+    for (const auto& device : std::as_const(devices)) {
+        const int fd = openLedEventDevice(device);
+        if (fd < 0) {
+            watching = false;
+            break;
+        }
+        auto* file = new QFile(this);
+        if (!file->open(fd, QIODevice::ReadOnly | QIODevice::Unbuffered, QFileDevice::AutoCloseHandle)) {
+            ::close(fd);
+            delete file;
+            watching = false;
+            break;
+        }
+        auto* notifier = new QSocketNotifier(file->handle(), QSocketNotifier::Read, file);
+        connect(notifier, &QSocketNotifier::activated, this, [this, file, notifier] {
+            if (!readLedEvents(file->handle())) {
+                // Keyboard went away
+                notifier->setEnabled(false);
+                startLedPolling();
+            }
+        });
+        m_ledDevices.append(file);
+    }
+
+    if (watching) {
+        qDebug() << "NiriIpc: Watching LED state via" << devices;
+        return;
+    }
+
+    qDeleteAll(m_ledDevices);
+    m_ledDevices.clear();
+    startLedPolling();
+}
+
+void NiriIpc::startLedPolling() {
+    if (m_ledPollTimer.isActive()) return;
+    m_ledPollTimer.setInterval(1000);
+    connect(&m_ledPollTimer, &QTimer::timeout, this, &NiriIpc::readLedState, Qt::UniqueConnection);
+    m_ledPollTimer.start();
+    readLedState();
+}
+
+bool NiriIpc::readLedEvents(int fd) {
+    std::array<input_event, 16> events;
+    const ssize_t bytes = ::read(fd, events.data(), sizeof(events));
+    if (bytes < 0) return errno == EAGAIN || errno == EINTR;
+    if (bytes == 0) return false;
+
+    const auto count = static_cast<std::size_t>(bytes) / sizeof(input_event);
+    for (std::size_t i = 0; i < count; ++i) {
+        const input_event& ev = events[i];
+        if (ev.type != EV_LED) continue;
+
+        const bool on = ev.value != 0;
+        if (ev.code == LED_CAPSL && !m_capsLockPath.isEmpty() && m_capsLock != on) {
+            m_capsLock = on;
+            emit capsLockChanged();
+        } else if (ev.code == LED_NUML && !m_numLockPath.isEmpty() && m_numLock != on) {
+            m_numLock = on;
+            emit numLockChanged();
+        }
     }
+    return true;
 }
 
 void NiriIpc::readLedState() {
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "nirimodels.hpp"
 #include "nirisocket.hpp"
 
+#include <qfile.h>
 #include <qhash.h>
 #include <qjsonarray.h>
 #include <qjsonobject.h>
@@ -12,28 +14,10 @@
 #include <QVariant>
 #include <QList>
 
-namespace caelestia {
-
-class NiriListModel : public QAbstractListModel {
-    Q_OBJECT
-public:
-    enum Roles { ObjectRole = Qt::UserRole + 1 };
+#include <optional>
+#include <string_view>
 
-    explicit NiriListModel(QObject* parent = nullptr);
-
-    QHash<int, QByteArray> roleNames() const override;
-    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
-    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
-
-    void resetData(const QVariantList& items);
-    void appendItem(const QVariantMap& item);
-    void setItem(int idx, const QVariantMap& item);
-    void removeItem(int idx);
-    const QVariantList& items() const;
-
-private:
-    QVariantList m_items;
-};
+namespace caelestia {
 
 /// NiriIpc — QML singleton providing native IPC access to the niri compositor.
 ///
@@ -47,6 +31,7 @@ class NiriIpc : public QObject {
 
     // ── Core ──
     Q_PROPERTY(bool available READ available NOTIFY availableChanged)
+    Q_PROPERTY(bool coalesceEvents READ coalesceEvents WRITE setCoalesceEvents NOTIFY coalesceEventsChanged)
 
     // ── Workspaces ──
     Q_PROPERTY(QAbstractListModel* workspacesModel READ workspacesModel CONSTANT)
@@ -87,6 +72,12 @@ public:
     // ── Property getters ──
     [[nodiscard]] bool available() const;
 
+    /// When enabled, state derived from a burst of events is recomputed and its
+    /// change signals are emitted at most once per event loop pass instead of
+    /// once per event.
+    [[nodiscard]] bool coalesceEvents() const;
+    void setCoalesceEvents(bool coalesce);
+
     [[nodiscard]] QAbstractListModel* workspacesModel() const;
     [[nodiscard]] QVariantList workspaces() const;
     [[nodiscard]] int focusedWorkspaceIndex() const;
@@ -117,16 +108,34 @@ public:
     [[nodiscard]] bool numLock() const;
 
     // ── Actions (Q_INVOKABLE for QML) ──
+    /// Sends a niri action by its CLI name with CLI-style args, e.g.
+    /// ("focus-window", ["--id", 42]) or ("set-column-width", ["+10%"]). Known
+    /// actions are checked against their schema and rejected with a warning if
+    /// the args don't fit it, including a missing --id where one is required.
+    /// Unknown actions are sent as {"Name": {}} and rejected if given args.
     Q_INVOKABLE bool action(const QString& actionName, const QVariantList& args = {});
 
+    // Typed shortcuts for common actions. An id of -1 targets the focused window
+    // and a delay of -1 uses niri's default.
+    Q_INVOKABLE bool focusWorkspace(int index);
+    Q_INVOKABLE bool moveWindowToWorkspace(int index);
+    Q_INVOKABLE bool focusWindow(qint64 id);
+    Q_INVOKABLE bool closeWindow(qint64 id = -1);
+    Q_INVOKABLE bool toggleWindowFloating(qint64 id = -1);
+    Q_INVOKABLE bool moveColumnToIndex(int index);
+    Q_INVOKABLE bool doScreenTransition(int delayMs = -1);
+
     // ── Workspace Helpers ──
     Q_INVOKABLE int getWorkspaceIdxById(int workspaceId) const;
     Q_INVOKABLE QVariantList getWindowsByWorkspaceId(int wsId) const;
     Q_INVOKABLE QVariantList getWindowsByWorkspaceIndex(int index) const;
     Q_INVOKABLE QVariantList getActiveWorkspaceWindows() const;
+    /// Live model of the windows on workspace `wsId`, owned by NiriIpc.
+    Q_INVOKABLE QAbstractItemModel* workspaceWindowsModel(int wsId);
 
 signals:
     void availableChanged();
+    void coalesceEventsChanged();
     void workspacesChanged();
     void focusedWorkspaceChanged();
     void workspaceHasWindowsChanged();
@@ -144,16 +153,32 @@ signals:
 private slots:
     void onEventStreamConnected();
     void onEventStreamDisconnected();
-    void onEvent(const QJsonObject& event);
+    void onEvent(const QByteArray& line);
 
 private:
+    /// Derived state and change signals that can be deferred to the end of a batch.
+    enum PendingChange : quint32 {
+        WorkspacesPending = 1 << 0,
+        FocusedWorkspacePending = 1 << 1,
+        WindowsPending = 1 << 2,
+        FocusedWindowPending = 1 << 3,
+        WorkspaceHasWindowsPending = 1 << 4,
+        CurrentOutputWorkspacesPending = 1 << 5,
+    };
+
+    void markPending(quint32 changes);
+    void flushPending();
+
+    bool sendAction(std::string_view name, std::optional<qint64> arg = std::nullopt);
+
     void fetchInitialState();
-    void handleWorkspacesChanged(const QJsonObject& data);
-    void handleWindowsChanged(const QJsonObject& data);
-    void handleWindowOpenedOrChanged(const QJsonObject& data);
-    void handleWindowClosed(const QJsonObject& data);
-    void handleWindowFocusChanged(const QJsonObject& data);
-    void handleWindowLayoutsChanged(const QJsonObject& data);
+    void applyWorkspacesChanged(const QList<NiriWorkspace>& workspaceList);
+    void applyWorkspaceActivated(qint64 id);
+    void applyWindowsChanged(const QList<NiriWindow>& windowList);
+    void applyWindowOpenedOrChanged(const NiriWindow& window);
+    void applyWindowClosed(qint64 closedId);
+    void applyWindowFocusChanged(qint64 id);
+    void applyWindowLayoutsChanged(const QList<std::pair<qint64, NiriWindowLayout>>& changes);
     void handleOutputsChanged(const QJsonObject& data);
     void handleKeyboardLayoutsChanged(const QJsonObject& data);
     void handleOverviewOpenedOrClosed(const QJsonObject& data);
@@ -162,19 +187,29 @@ private:
     void updateWorkspaceHasWindows();
     void updateFocusedWindowFields();
     void sortWindowsList();
-    void sortWindowsIfDirty();
     void rebuildWindowIndex();
+    void invalidateWindowsView();
+    void invalidateWorkspacesView();
     int findWindowIndexById(qint64 id) const;
+    void indexWindowWorkspace(qint64 windowId, qint64 oldWorkspaceId, qint64 newWorkspaceId);
+    void rebuildWorkspaceWindowIndex();
     void setupLedWatchers();
     void readLedState();
+    void startLedPolling();
+    bool readLedEvents(int fd);
 
     NiriEventSocket m_eventSocket;
     NiriRequestSocket m_requestSocket;
 
     bool m_available = false;
+    bool m_coalesceEvents = false;
+    quint32 m_pending = 0;
+    QTimer m_flushTimer;
 
     // Workspace state
-    NiriListModel* m_workspacesModel;
+    NiriWorkspaceModel* m_workspacesModel;
+    mutable QVariantList m_workspacesView; // Lazily materialized for the workspaces property
+    mutable bool m_workspacesViewDirty = true;
     int m_focusedWorkspaceIndex = -1;
     int m_focusedWorkspaceId = -1;
     QString m_focusedMonitorName;
@@ -182,9 +217,12 @@ private:
     QVariantMap m_workspaceHasWindows;
 
     // Window state
-    NiriListModel* m_windowsModel;
-    QHash<qint64, int> m_windowIndex; // window ID -> index in m_windows for O(1) lookup
-    bool m_windowsSortDirty = false;
+    NiriWindowModel* m_windowsModel;
+    mutable QVariantList m_windowsView; // Lazily materialized for the windows property
+    mutable bool m_windowsViewDirty = true;
+    QHash<qint64, int> m_windowIndex; // window ID -> row in m_windowsModel for O(1) lookup
+    QHash<qint64, QList<qint64>> m_windowsByWorkspace; // workspace ID -> IDs of its windows
+    QHash<qint64, NiriWorkspaceWindowsModel*> m_workspaceWindowsModels;
     int m_focusedWindowIndex = -1;
     QString m_focusedWindowId;
     QString m_focusedWindowTitle;
@@ -206,6 +244,7 @@ private:
     // LED state
     bool m_capsLock = false;
     bool m_numLock = false;
+    QList<QFile*> m_ledDevices; // Keyboard evdev nodes; empty when polling
     QTimer m_ledPollTimer;
     QString m_capsLockPath;
     QString m_numLockPath;
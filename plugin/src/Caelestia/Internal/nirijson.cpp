@@ -0,0 +1,437 @@
+#include "nirijson.hpp"
+
+#include <charconv>
+
+namespace caelestia {
+
+// ── NiriJsonReader ───────────────────────────────────────────────────
+
+NiriJsonReader::NiriJsonReader(std::string_view data)
+    : m_data(data) {}
+
+void NiriJsonReader::skipWhitespace() {
+    while (m_pos < m_data.size()) {
+        const char c = m_data[m_pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+        ++m_pos;
+    }
+}
+
+bool NiriJsonReader::fail() {
+    m_error = true;
+    return false;
+}
+
+bool NiriJsonReader::expect(char c) {
+    if (m_error) return false;
+    skipWhitespace();
+    if (m_pos >= m_data.size() || m_data[m_pos] != c) return fail();
+    ++m_pos;
+    return true;
+}
+
+bool NiriJsonReader::enterObject() {
+    return expect('{');
+}
+
+bool NiriJsonReader::nextKey(std::string_view& key) {
+    if (m_error) return false;
+    skipWhitespace();
+    if (m_pos >= m_data.size()) return fail();
+
+    if (m_data[m_pos] == ',') {
+        ++m_pos;
+        skipWhitespace();
+    } else if (m_data[m_pos] == '}') {
+        ++m_pos;
+        return false;
+    }
+
+    if (!readString(key, m_scratch)) return false;
+    return expect(':');
+}
+
+bool NiriJsonReader::enterArray() {
+    return expect('[');
+}
+
+bool NiriJsonReader::nextElement() {
+    if (m_error) return false;
+    skipWhitespace();
+    if (m_pos >= m_data.size()) return fail();
+
+    if (m_data[m_pos] == ',') {
+        ++m_pos;
+        skipWhitespace();
+    } else if (m_data[m_pos] == ']') {
+        ++m_pos;
+        return false;
+    }
+    return m_pos < m_data.size() || fail();
+}
+
+bool NiriJsonReader::skipNull() {
+    if (m_error) return false;
+    skipWhitespace();
+    if (m_data.substr(m_pos, 4) != "null") return false;
+    m_pos += 4;
+    return true;
+}
+
+static void appendUtf8(std::string& out, char32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+static bool parseHex4(std::string_view s, char32_t& out) {
+    if (s.size() < 4) return false;
+    unsigned value = 0;
+    const auto res = std::from_chars(s.data(), s.data() + 4, value, 16);
+    if (res.ec != std::errc() || res.ptr != s.data() + 4) return false;
+    out = value;
+    return true;
+}
+
+bool NiriJsonReader::readString(std::string_view& out, std::string& scratch) {
+    if (!expect('"')) return false;
+
+    const std::size_t start = m_pos;
+    const std::size_t end = m_data.find_first_of("\"\\", start);
+    if (end == std::string_view::npos) return fail();
+
+    // Fast path: no escapes, hand back a view into the input
+    if (m_data[end] == '"') {
+        out = m_data.substr(start, end - start);
+        m_pos = end + 1;
+        return true;
+    }
+
+    scratch.assign(m_data.substr(start, end - start));
+    m_pos = end;
+    while (m_pos < m_data.size()) {
+        const char c = m_data[m_pos++];
+        if (c == '"') {
+            out = scratch;
+            return true;
+        }
+        if (c != '\\') {
+            scratch.push_back(c);
+            continue;
+        }
+        if (m_pos >= m_data.size()) return fail();
+
+        switch (const char esc = m_data[m_pos++]) {
+        case '"':
+        case '\\':
+        case '/':
+            scratch.push_back(esc);
+            break;
+        case 'b':
+            scratch.push_back('\b');
+            break;
+        case 'f':
+            scratch.push_back('\f');
+            break;
+        case 'n':
+            scratch.push_back('\n');
+            break;
+        case 'r':
+            scratch.push_back('\r');
+            break;
+        case 't':
+            scratch.push_back('\t');
+            break;
+        case 'u': {
+            char32_t cp;
+            if (!parseHex4(m_data.substr(m_pos), cp)) return fail();
+            m_pos += 4;
+            // Combine UTF-16 surrogate pairs, replace lone surrogates
+            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                char32_t low;
+                if (m_data.substr(m_pos, 2) == "\\u" && parseHex4(m_data.substr(m_pos + 2), low) && low >= 0xDC00 &&
+                    low <= 0xDFFF) {
+                    m_pos += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else {
+                    cp = 0xFFFD;
+                }
+            } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                cp = 0xFFFD;
+            }
+            appendUtf8(scratch, cp);
+            break;
+        }
+        default:
+            return fail();
+        }
+    }
+    return fail();
+}
+
+bool NiriJsonReader::readInt(qint64& out) {
+    if (m_error) return false;
+    skipWhitespace();
+    const char* begin = m_data.data() + m_pos;
+    const char* end = m_data.data() + m_data.size();
+    const auto res = std::from_chars(begin, end, out);
+    if (res.ec != std::errc()) return fail();
+    m_pos += static_cast<std::size_t>(res.ptr - begin);
+
+    // Tolerate integral values written with a fraction or exponent
+    if (m_pos < m_data.size() && (m_data[m_pos] == '.' || m_data[m_pos] == 'e' || m_data[m_pos] == 'E')) {
+        m_pos -= static_cast<std::size_t>(res.ptr - begin);
+        double d;
+        if (!readDouble(d)) return false;
+        out = static_cast<qint64>(d);
+    }
+    return true;
+}
+
+bool NiriJsonReader::readDouble(double& out) {
+    if (m_error) return false;
+    skipWhitespace();
+    const char* begin = m_data.data() + m_pos;
+    const char* end = m_data.data() + m_data.size();
+    const auto res = std::from_chars(begin, end, out);
+    if (res.ec != std::errc()) return fail();
+    m_pos += static_cast<std::size_t>(res.ptr - begin);
+    return true;
+}
+
+bool NiriJsonReader::readBool(bool& out) {
+    if (m_error) return false;
+    skipWhitespace();
+    if (m_data.substr(m_pos, 4) == "true") {
+        m_pos += 4;
+        out = true;
+        return true;
+    }
+    if (m_data.substr(m_pos, 5) == "false") {
+        m_pos += 5;
+        out = false;
+        return true;
+    }
+    return fail();
+}
+
+bool NiriJsonReader::skipValue() {
+    if (m_error) return false;
+    skipWhitespace();
+    if (m_pos >= m_data.size()) return fail();
+
+    switch (m_data[m_pos]) {
+    case '{': {
+        enterObject();
+        std::string_view key;
+        while (nextKey(key)) {
+            if (!skipValue()) return false;
+        }
+        return !m_error;
+    }
+    case '[':
+        enterArray();
+        while (nextElement()) {
+            if (!skipValue()) return false;
+        }
+        return !m_error;
+    case '"': {
+        std::string_view str;
+        return readString(str, m_scratch);
+    }
+    case 't':
+    case 'f': {
+        bool b;
+        return readBool(b);
+    }
+    case 'n':
+        return skipNull() || fail();
+    default: {
+        double d;
+        return readDouble(d);
+    }
+    }
+}
+
+std::string_view NiriJsonReader::rawValue() {
+    skipWhitespace();
+    const std::size_t start = m_pos;
+    if (!skipValue()) return {};
+    return m_data.substr(start, m_pos - start);
+}
+
+QString NiriJsonReader::readQString() {
+    if (skipNull()) return QString();
+    std::string_view str;
+    if (!readString(str, m_scratch)) return QString();
+    return QString::fromUtf8(str.data(), static_cast<qsizetype>(str.size()));
+}
+
+qint64 NiriJsonReader::readOptionalInt(qint64 fallback) {
+    if (skipNull()) return fallback;
+    qint64 value = fallback;
+    readInt(value);
+    return value;
+}
+
+// ── Typed decoders ───────────────────────────────────────────────────
+
+static bool readPair(NiriJsonReader& reader, double& a, double& b) {
+    if (!reader.enterArray()) return false;
+    bool ok = reader.nextElement() && reader.readDouble(a) && reader.nextElement() && reader.readDouble(b);
+    while (ok && reader.nextElement()) {
+        ok = reader.skipValue();
+    }
+    return ok && !reader.hasError();
+}
+
+bool readNiriWindowLayout(NiriJsonReader& reader, NiriWindowLayout& out) {
+    out = NiriWindowLayout();
+    if (!reader.enterObject()) return false;
+
+    std::string_view key;
+    while (reader.nextKey(key)) {
+        if (reader.skipNull()) continue;
+
+        double a = 0;
+        double b = 0;
+        if (key == "pos_in_scrolling_layout") {
+            if (!readPair(reader, a, b)) return false;
+            out.column = static_cast<int>(a);
+            out.row = static_cast<int>(b);
+            out.hasScrollingPos = true;
+        } else if (key == "tile_size") {
+            if (!readPair(reader, a, b)) return false;
+            out.tileSize = QSizeF(a, b);
+        } else if (key == "window_size") {
+            if (!readPair(reader, a, b)) return false;
+            out.windowSize = QSize(static_cast<int>(a), static_cast<int>(b));
+        } else if (key == "tile_pos_in_workspace_view") {
+            if (!readPair(reader, a, b)) return false;
+            out.tilePos = QPointF(a, b);
+            out.hasTilePos = true;
+        } else if (key == "window_offset_in_tile") {
+            if (!readPair(reader, a, b)) return false;
+            out.windowOffset = QPointF(a, b);
+        } else if (!reader.skipValue()) {
+            return false;
+        }
+    }
+    return !reader.hasError();
+}
+
+bool readNiriWindow(NiriJsonReader& reader, NiriWindow& out) {
+    out = NiriWindow();
+    if (!reader.enterObject()) return false;
+
+    std::string_view key;
+    while (reader.nextKey(key)) {
+        if (key == "id") {
+            out.id = reader.readOptionalInt();
+        } else if (key == "title") {
+            out.title = reader.readQString();
+        } else if (key == "app_id") {
+            out.appId = reader.readQString();
+        } else if (key == "pid") {
+            out.pid = reader.readOptionalInt();
+        } else if (key == "workspace_id") {
+            out.workspaceId = reader.readOptionalInt();
+        } else if (key == "is_focused") {
+            reader.readBool(out.isFocused);
+        } else if (key == "is_floating") {
+            reader.readBool(out.isFloating);
+        } else if (key == "is_urgent") {
+            reader.readBool(out.isUrgent);
+        } else if (key == "layout") {
+            if (!reader.skipNull()) readNiriWindowLayout(reader, out.layout);
+        } else {
+            reader.skipValue();
+        }
+        if (reader.hasError()) return false;
+    }
+    return !reader.hasError();
+}
+
+bool readNiriWorkspace(NiriJsonReader& reader, NiriWorkspace& out) {
+    out = NiriWorkspace();
+    if (!reader.enterObject()) return false;
+
+    std::string_view key;
+    while (reader.nextKey(key)) {
+        if (key == "id") {
+            out.id = reader.readOptionalInt();
+        } else if (key == "idx") {
+            out.idx = static_cast<int>(reader.readOptionalInt(0));
+        } else if (key == "name") {
+            out.name = reader.readQString();
+        } else if (key == "output") {
+            out.output = reader.readQString();
+        } else if (key == "is_urgent") {
+            reader.readBool(out.isUrgent);
+        } else if (key == "is_active") {
+            reader.readBool(out.isActive);
+        } else if (key == "is_focused") {
+            reader.readBool(out.isFocused);
+        } else if (key == "active_window_id") {
+            out.activeWindowId = reader.readOptionalInt();
+        } else {
+            reader.skipValue();
+        }
+        if (reader.hasError()) return false;
+    }
+    return !reader.hasError();
+}
+
+bool readNiriWindowList(NiriJsonReader& reader, QList<NiriWindow>& out) {
+    out.clear();
+    if (!reader.enterArray()) return false;
+    while (reader.nextElement()) {
+        NiriWindow win;
+        if (!readNiriWindow(reader, win)) return false;
+        out.append(std::move(win));
+    }
+    return !reader.hasError();
+}
+
+bool readNiriWorkspaceList(NiriJsonReader& reader, QList<NiriWorkspace>& out) {
+    out.clear();
+    if (!reader.enterArray()) return false;
+    while (reader.nextElement()) {
+        NiriWorkspace ws;
+        if (!readNiriWorkspace(reader, ws)) return false;
+        out.append(std::move(ws));
+    }
+    return !reader.hasError();
+}
+
+bool readNiriLayoutChanges(NiriJsonReader& reader, QList<std::pair<qint64, NiriWindowLayout>>& out) {
+    out.clear();
+    if (!reader.enterArray()) return false;
+    while (reader.nextElement()) {
+        // Each change is an [id, layout] pair
+        std::pair<qint64, NiriWindowLayout> change;
+        if (!reader.enterArray() || !reader.nextElement() || !reader.readInt(change.first) || !reader.nextElement() ||
+            !readNiriWindowLayout(reader, change.second)) {
+            return false;
+        }
+        while (reader.nextElement()) {
+            if (!reader.skipValue()) return false;
+        }
+        out.append(std::move(change));
+    }
+    return !reader.hasError();
+}
+
+} // namespace caelestia
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "nirimodels.hpp"
+
+#include <qlist.h>
+#include <qstring.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace caelestia {
+
+/// Pull-style JSON reader over a single in-memory document.
+/// Walks the input in place without building a DOM; strings are returned as
+/// views into the input unless they contain escapes, in which case they are
+/// decoded into a caller-provided scratch buffer. Any malformed input sets the
+/// error flag, after which every read fails.
+class NiriJsonReader {
+public:
+    explicit NiriJsonReader(std::string_view data);
+
+    [[nodiscard]] bool hasError() const { return m_error; }
+
+    /// Consumes '{'. Iterate members with nextKey().
+    bool enterObject();
+    /// Reads the next member key of the current object, or consumes '}' and returns false.
+    bool nextKey(std::string_view& key);
+
+    /// Consumes '['. Iterate elements with nextElement().
+    bool enterArray();
+    /// Positions on the next element of the current array, or consumes ']' and returns false.
+    bool nextElement();
+
+    /// Returns true and consumes the literal if the next value is null.
+    bool skipNull();
+
+    bool readString(std::string_view& out, std::string& scratch);
+    bool readInt(qint64& out);
+    bool readDouble(double& out);
+    bool readBool(bool& out);
+
+    /// Skips the next value, whatever its type.
+    bool skipValue();
+    /// Skips the next value and returns the raw text it spanned.
+    std::string_view rawValue();
+
+    QString readQString();
+    /// Reads an integer, mapping null to `fallback`.
+    qint64 readOptionalInt(qint64 fallback = -1);
+
+private:
+    void skipWhitespace();
+    bool expect(char c);
+    bool fail();
+
+    std::string_view m_data;
+    std::size_t m_pos = 0;
+    bool m_error = false;
+    std::string m_scratch;
+};
+
+/// Decoders from the reader straight into the typed niri store.
+bool readNiriWindowLayout(NiriJsonReader& reader, NiriWindowLayout& out);
+bool readNiriWindow(NiriJsonReader& reader, NiriWindow& out);
+bool readNiriWorkspace(NiriJsonReader& reader, NiriWorkspace& out);
+bool readNiriWindowList(NiriJsonReader& reader, QList<NiriWindow>& out);
+bool readNiriWorkspaceList(NiriJsonReader& reader, QList<NiriWorkspace>& out);
+bool readNiriLayoutChanges(NiriJsonReader& reader, QList<std::pair<qint64, NiriWindowLayout>>& out);
+
+} // namespace caelestia
@@ -0,0 +1,283 @@
+#include "nirimodels.hpp"
+
+#include <qjsonarray.h>
+#include <qjsonvalue.h>
+
+namespace caelestia {
+
+// ── Conversion helpers ───────────────────────────────────────────────
+
+static QVariant nullable(qint64 value) {
+    return value >= 0 ? QVariant(value) : QVariant::fromValue(nullptr);
+}
+
+static QVariant nullable(const QString& value) {
+    return value.isNull() ? QVariant::fromValue(nullptr) : QVariant(value);
+}
+
+static QString stringOrNull(const QJsonValue& value) {
+    return value.isString() ? value.toString() : QString();
+}
+
+static qint64 idOrNone(const QJsonValue& value) {
+    return value.isDouble() ? value.toInteger() : -1;
+}
+
+// ── NiriWindowLayout ─────────────────────────────────────────────────
+
+QVariantMap NiriWindowLayout::toVariantMap() const {
+    QVariantMap map;
+    map[QStringLiteral("pos_in_scrolling_layout")] =
+        hasScrollingPos ? QVariant(QVariantList{ column, row }) : QVariant::fromValue(nullptr);
+    map[QStringLiteral("tile_size")] = QVariantList{ tileSize.width(), tileSize.height() };
+    map[QStringLiteral("window_size")] = QVariantList{ windowSize.width(), windowSize.height() };
+    map[QStringLiteral("tile_pos_in_workspace_view")] =
+        hasTilePos ? QVariant(QVariantList{ tilePos.x(), tilePos.y() }) : QVariant::fromValue(nullptr);
+    map[QStringLiteral("window_offset_in_tile")] = QVariantList{ windowOffset.x(), windowOffset.y() };
+    return map;
+}
+
+NiriWindowLayout NiriWindowLayout::fromJson(const QJsonObject& obj) {
+    NiriWindowLayout layout;
+
+    const QJsonArray pos = obj.value(QStringLiteral("pos_in_scrolling_layout")).toArray();
+    if (pos.size() >= 2) {
+        layout.column = pos.at(0).toInt();
+        layout.row = pos.at(1).toInt();
+        layout.hasScrollingPos = true;
+    }
+
+    const QJsonArray tile = obj.value(QStringLiteral("tile_size")).toArray();
+    if (tile.size() >= 2) layout.tileSize = QSizeF(tile.at(0).toDouble(), tile.at(1).toDouble());
+
+    const QJsonArray win = obj.value(QStringLiteral("window_size")).toArray();
+    if (win.size() >= 2) layout.windowSize = QSize(win.at(0).toInt(), win.at(1).toInt());
+
+    const QJsonArray tilePos = obj.value(QStringLiteral("tile_pos_in_workspace_view")).toArray();
+    if (tilePos.size() >= 2) {
+        layout.tilePos = QPointF(tilePos.at(0).toDouble(), tilePos.at(1).toDouble());
+        layout.hasTilePos = true;
+    }
+
+    const QJsonArray offset = obj.value(QStringLiteral("window_offset_in_tile")).toArray();
+    if (offset.size() >= 2) layout.windowOffset = QPointF(offset.at(0).toDouble(), offset.at(1).toDouble());
+
+    return layout;
+}
+
+// ── NiriWindow ───────────────────────────────────────────────────────
+
+QVariantMap NiriWindow::toVariantMap() const {
+    QVariantMap map;
+    map[QStringLiteral("id")] = id;
+    map[QStringLiteral("title")] = nullable(title);
+    map[QStringLiteral("app_id")] = nullable(appId);
+    map[QStringLiteral("pid")] = nullable(pid);
+    map[QStringLiteral("workspace_id")] = nullable(workspaceId);
+    map[QStringLiteral("is_focused")] = isFocused;
+    map[QStringLiteral("is_floating")] = isFloating;
+    map[QStringLiteral("is_urgent")] = isUrgent;
+    map[QStringLiteral("layout")] = layout.toVariantMap();
+    return map;
+}
+
+NiriWindow NiriWindow::fromJson(const QJsonObject& obj) {
+    NiriWindow win;
+    win.id = obj.value(QStringLiteral("id")).toInteger(-1);
+    win.title = stringOrNull(obj.value(QStringLiteral("title")));
+    win.appId = stringOrNull(obj.value(QStringLiteral("app_id")));
+    win.pid = idOrNone(obj.value(QStringLiteral("pid")));
+    win.workspaceId = idOrNone(obj.value(QStringLiteral("workspace_id")));
+    win.isFocused = obj.value(QStringLiteral("is_focused")).toBool();
+    win.isFloating = obj.value(QStringLiteral("is_floating")).toBool();
+    win.isUrgent = obj.value(QStringLiteral("is_urgent")).toBool();
+    win.layout = NiriWindowLayout::fromJson(obj.value(QStringLiteral("layout")).toObject());
+    return win;
+}
+
+// ── NiriWorkspace ────────────────────────────────────────────────────
+
+QVariantMap NiriWorkspace::toVariantMap() const {
+    QVariantMap map;
+    map[QStringLiteral("id")] = id;
+    map[QStringLiteral("idx")] = idx;
+    map[QStringLiteral("name")] = nullable(name);
+    map[QStringLiteral("output")] = nullable(output);
+    map[QStringLiteral("is_urgent")] = isUrgent;
+    map[QStringLiteral("is_active")] = isActive;
+    map[QStringLiteral("is_focused")] = isFocused;
+    map[QStringLiteral("active_window_id")] = nullable(activeWindowId);
+    return map;
+}
+
+NiriWorkspace NiriWorkspace::fromJson(const QJsonObject& obj) {
+    NiriWorkspace ws;
+    ws.id = obj.value(QStringLiteral("id")).toInteger(-1);
+    ws.idx = obj.value(QStringLiteral("idx")).toInt();
+    ws.name = stringOrNull(obj.value(QStringLiteral("name")));
+    ws.output = stringOrNull(obj.value(QStringLiteral("output")));
+    ws.isUrgent = obj.value(QStringLiteral("is_urgent")).toBool();
+    ws.isActive = obj.value(QStringLiteral("is_active")).toBool();
+    ws.isFocused = obj.value(QStringLiteral("is_focused")).toBool();
+    ws.activeWindowId = idOrNone(obj.value(QStringLiteral("active_window_id")));
+    return ws;
+}
+
+// ── NiriWindowModel ──────────────────────────────────────────────────
+
+NiriWindowModel::NiriWindowModel(QObject* parent)
+    : NiriListModel<NiriWindow>(parent) {}
+
+QHash<int, QByteArray> NiriWindowModel::roleNames() const {
+    return {
+        { ObjectRole, "modelData" },
+        { IdRole, "windowId" },
+        { TitleRole, "title" },
+        { AppIdRole, "appId" },
+        { PidRole, "pid" },
+        { WorkspaceIdRole, "workspaceId" },
+        { IsFocusedRole, "isFocused" },
+        { IsFloatingRole, "isFloating" },
+        { IsUrgentRole, "isUrgent" },
+        { ColumnRole, "column" },
+        { RowRole, "row" },
+        { LayoutRole, "layout" },
+    };
+}
+
+QVariant NiriWindowModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_items.size() || index.row() < 0) return {};
+
+    const NiriWindow& win = m_items.at(index.row());
+    switch (role) {
+    case ObjectRole:
+        return win.toVariantMap();
+    case IdRole:
+        return win.id;
+    case TitleRole:
+        return win.title;
+    case AppIdRole:
+        return win.appId;
+    case PidRole:
+        return win.pid;
+    case WorkspaceIdRole:
+        return win.workspaceId;
+    case IsFocusedRole:
+        return win.isFocused;
+    case IsFloatingRole:
+        return win.isFloating;
+    case IsUrgentRole:
+        return win.isUrgent;
+    case ColumnRole:
+        return win.layout.column;
+    case RowRole:
+        return win.layout.row;
+    case LayoutRole:
+        return win.layout.toVariantMap();
+    default:
+        return {};
+    }
+}
+
+QList<int> NiriWindowModel::changedRoles(const NiriWindow& a, const NiriWindow& b) const {
+    QList<int> roles;
+    if (a == b) return roles;
+
+    roles.append(ObjectRole);
+    if (a.id != b.id) roles.append(IdRole);
+    if (a.title != b.title) roles.append(TitleRole);
+    if (a.appId != b.appId) roles.append(AppIdRole);
+    if (a.pid != b.pid) roles.append(PidRole);
+    if (a.workspaceId != b.workspaceId) roles.append(WorkspaceIdRole);
+    if (a.isFocused != b.isFocused) roles.append(IsFocusedRole);
+    if (a.isFloating != b.isFloating) roles.append(IsFloatingRole);
+    if (a.isUrgent != b.isUrgent) roles.append(IsUrgentRole);
+    if (a.layout.column != b.layout.column) roles.append(ColumnRole);
+    if (a.layout.row != b.layout.row) roles.append(RowRole);
+    if (a.layout != b.layout) roles.append(LayoutRole);
+    return roles;
+}
+
+// ── NiriWorkspaceModel ───────────────────────────────────────────────
+
+NiriWorkspaceModel::NiriWorkspaceModel(QObject* parent)
+    : NiriListModel<NiriWorkspace>(parent) {}
+
+QHash<int, QByteArray> NiriWorkspaceModel::roleNames() const {
+    return {
+        { ObjectRole, "modelData" },
+        { IdRole, "workspaceId" },
+        { IdxRole, "idx" },
+        { NameRole, "name" },
+        { OutputRole, "output" },
+        { IsUrgentRole, "isUrgent" },
+        { IsActiveRole, "isActive" },
+        { IsFocusedRole, "isFocused" },
+        { ActiveWindowIdRole, "activeWindowId" },
+    };
+}
+
+QVariant NiriWorkspaceModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_items.size() || index.row() < 0) return {};
+
+    const NiriWorkspace& ws = m_items.at(index.row());
+    switch (role) {
+    case ObjectRole:
+        return ws.toVariantMap();
+    case IdRole:
+        return ws.id;
+    case IdxRole:
+        return ws.idx;
+    case NameRole:
+        return ws.name;
+    case OutputRole:
+        return ws.output;
+    case IsUrgentRole:
+        return ws.isUrgent;
+    case IsActiveRole:
+        return ws.isActive;
+    case IsFocusedRole:
+        return ws.isFocused;
+    case ActiveWindowIdRole:
+        return ws.activeWindowId;
+    default:
+        return {};
+    }
+}
+
+QList<int> NiriWorkspaceModel::changedRoles(const NiriWorkspace& a, const NiriWorkspace& b) const {
+    QList<int> roles;
+    if (a == b) return roles;
+
+    roles.append(ObjectRole);
+    if (a.id != b.id) roles.append(IdRole);
+    if (a.idx != b.idx) roles.append(IdxRole);
+    if (a.name != b.name) roles.append(NameRole);
+    if (a.output != b.output) roles.append(OutputRole);
+    if (a.isUrgent != b.isUrgent) roles.append(IsUrgentRole);
+    if (a.isActive != b.isActive) roles.append(IsActiveRole);
+    if (a.isFocused != b.isFocused) roles.append(IsFocusedRole);
+    if (a.activeWindowId != b.activeWindowId) roles.append(ActiveWindowIdRole);
+    return roles;
+}
+
+// ── NiriWorkspaceWindowsModel ────────────────────────────────────────
+
+NiriWorkspaceWindowsModel::NiriWorkspaceWindowsModel(NiriWindowModel* source, qint64 workspaceId, QObject* parent)
+    : QSortFilterProxyModel(parent)
+    , m_source(source)
+    , m_workspaceId(workspaceId) {
+    setSourceModel(source);
+}
+
+qint64 NiriWorkspaceWindowsModel::workspaceId() const {
+    return m_workspaceId;
+}
+
+bool NiriWorkspaceWindowsModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const {
+    if (sourceParent.isValid()) return false;
+    const auto& items = m_source->items();
+    return sourceRow >= 0 && sourceRow < items.size() && items.at(sourceRow).workspaceId == m_workspaceId;
+}
+
+} // namespace caelestia
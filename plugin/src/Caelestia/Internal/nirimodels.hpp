@@ -0,0 +1,304 @@
+#pragma once
+
+#include <qabstractitemmodel.h>
+#include <qhash.h>
+#include <qjsonobject.h>
+#include <qlist.h>
+#include <qpoint.h>
+#include <qsortfilterproxymodel.h>
+#include <qsize.h>
+#include <qstring.h>
+#include <qvariant.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace caelestia {
+
+/// Mirrors niri_ipc::WindowLayout. Positions in the scrolling layout are 1-based.
+struct NiriWindowLayout {
+    int column = 0;
+    int row = 0;
+    bool hasScrollingPos = false;
+    QSizeF tileSize;
+    QSize windowSize;
+    QPointF tilePos;
+    bool hasTilePos = false;
+    QPointF windowOffset;
+
+    bool operator==(const NiriWindowLayout& other) const = default;
+
+    [[nodiscard]] QVariantMap toVariantMap() const;
+    static NiriWindowLayout fromJson(const QJsonObject& obj);
+};
+
+/// Mirrors niri_ipc::Window. Optional ids are -1 and optional strings are null when absent.
+struct NiriWindow {
+    qint64 id = -1;
+    QString title;
+    QString appId;
+    qint64 pid = -1;
+    qint64 workspaceId = -1;
+    bool isFocused = false;
+    bool isFloating = false;
+    bool isUrgent = false;
+    NiriWindowLayout layout;
+
+    bool operator==(const NiriWindow& other) const = default;
+
+    [[nodiscard]] QVariantMap toVariantMap() const;
+    static NiriWindow fromJson(const QJsonObject& obj);
+};
+
+/// Mirrors niri_ipc::Workspace.
+struct NiriWorkspace {
+    qint64 id = -1;
+    int idx = 0;
+    QString name;
+    QString output;
+    bool isUrgent = false;
+    bool isActive = false;
+    bool isFocused = false;
+    qint64 activeWindowId = -1;
+
+    bool operator==(const NiriWorkspace& other) const = default;
+
+    [[nodiscard]] QVariantMap toVariantMap() const;
+    static NiriWorkspace fromJson(const QJsonObject& obj);
+};
+
+/// List model over a typed niri store. Rows are keyed by the item's id, and
+/// updates are applied as targeted inserts, removals, moves and dataChanged
+/// notifications so delegates bound to the model are only touched when their
+/// own row changes.
+template <typename T>
+class NiriListModel : public QAbstractListModel {
+public:
+    using QAbstractListModel::QAbstractListModel;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override {
+        if (parent.isValid()) return 0;
+        return static_cast<int>(m_items.size());
+    }
+
+    const QList<T>& items() const { return m_items; }
+
+    int indexOfId(qint64 id) const {
+        for (int i = 0; i < m_items.size(); ++i) {
+            if (m_items.at(i).id == id) return i;
+        }
+        return -1;
+    }
+
+    void insertItem(int row, const T& item) {
+        row = std::clamp(row, 0, static_cast<int>(m_items.size()));
+        beginInsertRows(QModelIndex(), row, row);
+        m_items.insert(row, item);
+        endInsertRows();
+    }
+
+    void setItem(int idx, const T& item) {
+        if (idx < 0 || idx >= m_items.size()) return;
+        const QList<int> roles = changedRoles(m_items.at(idx), item);
+        if (roles.isEmpty()) return;
+        m_items[idx] = item;
+        emit dataChanged(index(idx), index(idx), roles);
+    }
+
+    void removeItem(int idx) {
+        if (idx < 0 || idx >= m_items.size()) return;
+        beginRemoveRows(QModelIndex(), idx, idx);
+        m_items.removeAt(idx);
+        endRemoveRows();
+    }
+
+    void moveItem(int from, int to) {
+        if (from == to || from < 0 || to < 0 || from >= m_items.size() || to >= m_items.size()) return;
+        // Destination is expressed in pre-move indices
+        beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to);
+        m_items.move(from, to);
+        endMoveRows();
+    }
+
+    /// Replaces the contents with `items`, matching rows by id. Rows that
+    /// vanished are removed, surviving rows are updated in place and new rows
+    /// are appended. Ordering is left to sortItems().
+    void replaceAll(const QList<T>& items) {
+        QHash<qint64, int> incoming;
+        incoming.reserve(items.size());
+        for (int i = 0; i < items.size(); ++i) {
+            incoming.insert(items.at(i).id, i);
+        }
+
+        for (int i = static_cast<int>(m_items.size()) - 1; i >= 0; --i) {
+            if (!incoming.contains(m_items.at(i).id)) removeItem(i);
+        }
+
+        QHash<qint64, int> existing;
+        existing.reserve(m_items.size());
+        for (int i = 0; i < m_items.size(); ++i) {
+            existing.insert(m_items.at(i).id, i);
+        }
+
+        QList<T> added;
+        for (const T& item : items) {
+            const auto it = existing.constFind(item.id);
+            if (it != existing.constEnd()) {
+                setItem(it.value(), item);
+            } else {
+                added.append(item);
+            }
+        }
+
+        if (!added.isEmpty()) {
+            const auto first = static_cast<int>(m_items.size());
+            beginInsertRows(QModelIndex(), first, first + static_cast<int>(added.size()) - 1);
+            m_items.append(added);
+            endInsertRows();
+        }
+    }
+
+    /// Stable-sorts the rows by `less` using the fewest row moves: rows on the
+    /// longest run already in relative order stay put, every other row is moved
+    /// directly behind its predecessor in the target order.
+    template <typename Less>
+    void sortItems(Less less) {
+        const auto n = static_cast<int>(m_items.size());
+        if (n < 2) return;
+
+        QList<int> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this, &less](int a, int b) {
+            return less(m_items.at(a), m_items.at(b));
+        });
+
+        QList<int> rank(n);
+        bool sorted = true;
+        for (int r = 0; r < n; ++r) {
+            rank[order.at(r)] = r;
+            sorted = sorted && order.at(r) == r;
+        }
+        if (sorted) return;
+
+        // Longest increasing subsequence of ranks, in O(n log n)
+        QList<int> tails;
+        QList<int> tailPos;
+        QList<int> prev(n, -1);
+        for (int i = 0; i < n; ++i) {
+            const auto pos = static_cast<int>(std::lower_bound(tails.begin(), tails.end(), rank.at(i)) - tails.begin());
+            if (pos > 0) prev[i] = tailPos.at(pos - 1);
+            if (pos == tails.size()) {
+                tails.append(rank.at(i));
+                tailPos.append(i);
+            } else {
+                tails[pos] = rank.at(i);
+                tailPos[pos] = i;
+            }
+        }
+        QList<bool> keep(n, false);
+        for (int i = tailPos.isEmpty() ? -1 : tailPos.last(); i >= 0; i = prev.at(i)) {
+            keep[i] = true;
+        }
+
+        // Track rows by rank so positions can be found after earlier moves
+        QList<qint64> idByRank(n);
+        for (int i = 0; i < n; ++i) {
+            idByRank[rank.at(i)] = m_items.at(i).id;
+        }
+        QList<bool> moveRank(n, false);
+        for (int i = 0; i < n; ++i) {
+            moveRank[rank.at(i)] = !keep.at(i);
+        }
+
+        for (int r = 0; r < n; ++r) {
+            if (!moveRank.at(r)) continue;
+            const int from = indexOfId(idByRank.at(r));
+            if (r == 0) {
+                moveItem(from, 0);
+                continue;
+            }
+            const int pred = indexOfId(idByRank.at(r - 1));
+            moveItem(from, from > pred ? pred + 1 : pred);
+        }
+    }
+
+protected:
+    /// Roles whose values differ between `a` and `b`; empty if nothing changed.
+    virtual QList<int> changedRoles(const T& a, const T& b) const = 0;
+
+    QList<T> m_items;
+};
+
+class NiriWindowModel : public NiriListModel<NiriWindow> {
+    Q_OBJECT
+
+public:
+    enum Roles {
+        ObjectRole = Qt::UserRole + 1,
+        IdRole,
+        TitleRole,
+        AppIdRole,
+        PidRole,
+        WorkspaceIdRole,
+        IsFocusedRole,
+        IsFloatingRole,
+        IsUrgentRole,
+        ColumnRole,
+        RowRole,
+        LayoutRole
+    };
+
+    explicit NiriWindowModel(QObject* parent = nullptr);
+
+    QHash<int, QByteArray> roleNames() const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+protected:
+    QList<int> changedRoles(const NiriWindow& a, const NiriWindow& b) const override;
+};
+
+class NiriWorkspaceModel : public NiriListModel<NiriWorkspace> {
+    Q_OBJECT
+
+public:
+    enum Roles {
+        ObjectRole = Qt::UserRole + 1,
+        IdRole,
+        IdxRole,
+        NameRole,
+        OutputRole,
+        IsUrgentRole,
+        IsActiveRole,
+        IsFocusedRole,
+        ActiveWindowIdRole
+    };
+
+    explicit NiriWorkspaceModel(QObject* parent = nullptr);
+
+    QHash<int, QByteArray> roleNames() const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+protected:
+    QList<int> changedRoles(const NiriWorkspace& a, const NiriWorkspace& b) const override;
+};
+
+/// Live view of the windows on a single workspace, in the source model's order.
+/// Only rows touched by a source change are re-filtered.
+class NiriWorkspaceWindowsModel : public QSortFilterProxyModel {
+    Q_OBJECT
+    Q_PROPERTY(qint64 workspaceId READ workspaceId CONSTANT)
+
+public:
+    explicit NiriWorkspaceWindowsModel(NiriWindowModel* source, qint64 workspaceId, QObject* parent = nullptr);
+
+    [[nodiscard]] qint64 workspaceId() const;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private:
+    NiriWindowModel* m_source;
+    qint64 m_workspaceId;
+};
+
+} // namespace caelestia
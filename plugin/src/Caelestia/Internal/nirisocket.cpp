@@ -1,11 +1,14 @@
 #include "nirisocket.hpp"
 
+#include "nirijson.hpp"
+
 #include <qdebug.h>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
 #include <qlocalsocket.h>
 #include <QProcessEnvironment>
 
+#include <algorithm>
 #include <memory>
 
 namespace caelestia {
@@ -41,6 +44,7 @@ void NiriEventSocket::connectToNiri() {
     }
 
     m_readBuffer.clear();
+    m_scanPos = 0;
     m_handshakeDone = false;
     m_reconnectDelay = 1000;
     m_socket->connectToServer(path);
@@ -71,32 +75,39 @@ void NiriEventSocket::onDisconnected() {
 }
 
 void NiriEventSocket::onReadyRead() {
-    m_readBuffer.append(m_socket->readAll());
-
-    int pos;
-    while ((pos = static_cast<int>(m_readBuffer.indexOf('\n'))) != -1) {
-        const QByteArray line = m_readBuffer.left(pos).trimmed();
-        m_readBuffer.remove(0, pos + 1);
+    // Read straight into the tail of the buffer instead of through a temporary
+    const qsizetype oldSize = m_readBuffer.size();
+    const qint64 available = m_socket->bytesAvailable();
+    if (available <= 0) return;
+    m_readBuffer.resize(oldSize + static_cast<qsizetype>(available));
+    const qint64 got = m_socket->read(m_readBuffer.data() + oldSize, available);
+    m_readBuffer.resize(oldSize + static_cast<qsizetype>(std::max<qint64>(got, 0)));
+
+    // Frame lines in place. The buffer only ever holds a partial line between
+    // reads, and m_scanPos remembers how much of it has already been searched,
+    // so fragmented payloads are scanned once and compacted once per read.
+    qsizetype start = 0;
+    qsizetype from = m_scanPos;
+    qsizetype pos;
+    while ((pos = m_readBuffer.indexOf('\n', from)) != -1) {
+        const QByteArray line = QByteArray::fromRawData(m_readBuffer.constData() + start, pos - start).trimmed();
+        start = pos + 1;
+        from = start;
         if (!line.isEmpty()) {
             processLine(line);
         }
     }
+    if (start > 0) m_readBuffer.remove(0, start);
+    m_scanPos = m_readBuffer.size();
 }
 
 void NiriEventSocket::processLine(const QByteArray& line) {
-    QJsonParseError err;
-    const QJsonDocument doc = QJsonDocument::fromJson(line, &err);
-    if (err.error != QJsonParseError::NoError) {
-        qWarning() << "NiriEventSocket: JSON parse error:" << err.errorString();
-        return;
-    }
-
-    const QJsonObject obj = doc.object();
-
     if (!m_handshakeDone) {
         // First response is {"Ok":"Handled"} for EventStream
-        if (!obj.contains(QStringLiteral("Ok"))) {
-            qWarning() << "NiriEventSocket: Critical handshake failure. Expected {\"Ok\":...}, got:" << doc.toJson(QJsonDocument::Compact);
+        NiriJsonReader reader(std::string_view(line.constData(), static_cast<std::size_t>(line.size())));
+        std::string_view key;
+        if (!reader.enterObject() || !reader.nextKey(key) || key != "Ok") {
+            qWarning() << "NiriEventSocket: Critical handshake failure. Expected {\"Ok\":...}, got:" << line;
             disconnectFromNiri();
             return;
         }
@@ -108,12 +119,9 @@ void NiriEventSocket::processLine(const QByteArray& line) {
         return;
     }
 
-    if (obj.isEmpty()) {
-        qWarning() << "NiriEventSocket: Received empty or invalid event JSON payload";
-        return;
-    }
-
-    emit eventReceived(obj);
+    // Decoding is left to the receiver so hot events never go through a DOM.
+    // The line may alias the read buffer, so hand out a detached copy.
+    emit eventReceived(QByteArray(line.constData(), line.size()));
 }
 
 void NiriEventSocket::onError(QLocalSocket::LocalSocketError error) {
@@ -132,6 +140,29 @@ void NiriEventSocket::scheduleReconnect() {
 
 // ── NiriRequestSocket ────────────────────────────────────────────────
 
+static void dispatchResponse(const QByteArray& line, const NiriRequestSocket::Callback& callback) {
+    if (!callback) return;
+
+    QJsonParseError err;
+    const QJsonDocument doc = QJsonDocument::fromJson(line, &err);
+    if (err.error != QJsonParseError::NoError) {
+        qWarning() << "NiriRequestSocket: JSON parse error:" << err.errorString();
+        callback(false, QJsonObject());
+        return;
+    }
+
+    const QJsonObject obj = doc.object();
+    if (obj.contains(QStringLiteral("Err"))) {
+        qWarning() << "NiriRequestSocket: IPC explicitly returned error:" << obj.value(QStringLiteral("Err"));
+        callback(false, obj);
+    } else if (obj.contains(QStringLiteral("Ok"))) {
+        callback(true, QJsonObject{{QStringLiteral("result"), obj.value(QStringLiteral("Ok"))}});
+    } else {
+        qWarning() << "NiriRequestSocket: Unrecognized IPC response schema (Missing 'Ok' or 'Err'):" << doc.toJson(QJsonDocument::Compact);
+        callback(false, obj);
+    }
+}
+
 NiriRequestSocket::NiriRequestSocket(QObject* parent)
     : QObject(parent) {}
 
@@ -149,6 +180,21 @@ void NiriRequestSocket::action(const QByteArray& payload) {
     }
 }
 
+void NiriRequestSocket::setPreconnect(bool preconnect) {
+    if (m_preconnect == preconnect) return;
+    m_preconnect = preconnect;
+
+    if (!m_preconnect) {
+        while (!m_spares.isEmpty()) {
+            dropSpare(m_spares.constLast());
+        }
+    }
+}
+
+bool NiriRequestSocket::preconnect() const {
+    return m_preconnect;
+}
+
 void NiriRequestSocket::processQueue() {
     if (m_queue.empty()) {
         m_busy = false;
@@ -170,14 +216,21 @@ void NiriRequestSocket::startRequest(const PendingRequest& req) {
         return;
     }
 
-    auto* sock = new QLocalSocket(this);
+    QLocalSocket* sock = takeConnection(path);
+    const bool fresh = !sock;
+    if (fresh) sock = new QLocalSocket(this);
     auto payload = req.payload;
     auto callback = req.callback;
 
-    connect(sock, &QLocalSocket::connected, this, [sock, payload]() {
+    const auto send = [sock, payload]() {
         sock->write(payload + "\n");
         sock->flush();
-    });
+    };
+    if (sock->state() == QLocalSocket::ConnectedState) {
+        send();
+    } else {
+        connect(sock, &QLocalSocket::connected, this, send);
+    }
 
     auto buffer = std::make_shared<QByteArray>();
 
@@ -189,26 +242,7 @@ void NiriRequestSocket::startRequest(const PendingRequest& req) {
     });
 
     connect(sock, &QLocalSocket::disconnected, this, [this, sock, buffer, callback]() {
-        if (callback) {
-            const QByteArray line = buffer->trimmed();
-            QJsonParseError err;
-            const QJsonDocument doc = QJsonDocument::fromJson(line, &err);
-            if (err.error != QJsonParseError::NoError) {
-                qWarning() << "NiriRequestSocket: JSON parse error:" << err.errorString();
-                callback(false, QJsonObject());
-            } else {
-                const QJsonObject obj = doc.object();
-                if (obj.contains(QStringLiteral("Err"))) {
-                    qWarning() << "NiriRequestSocket: IPC explicitly returned error:" << obj.value(QStringLiteral("Err"));
-                    callback(false, obj);
-                } else if (obj.contains(QStringLiteral("Ok"))) {
-                    callback(true, QJsonObject{{QStringLiteral("result"), obj.value(QStringLiteral("Ok"))}});
-                } else {
-                    qWarning() << "NiriRequestSocket: Unrecognized IPC response schema (Missing 'Ok' or 'Err'):" << doc.toJson(QJsonDocument::Compact);
-                    callback(false, obj);
-                }
-            }
-        }
+        dispatchResponse(buffer->trimmed(), callback);
         sock->deleteLater();
         processQueue();
     });
@@ -220,7 +254,53 @@ void NiriRequestSocket::startRequest(const PendingRequest& req) {
         processQueue();
     });
 
-    sock->connectToServer(path);
+    // Connect last, as a failure to connect is reported synchronously
+    if (fresh) sock->connectToServer(path);
+    topUpSpares(path);
+}
+
+// ── NiriRequestSocket (spare connections) ────────────────────────────
+
+QLocalSocket* NiriRequestSocket::takeConnection(const QString& path) {
+    while (!m_spares.isEmpty()) {
+        QLocalSocket* sock = m_spares.takeFirst();
+        // Spares are dropped as soon as they fail or close, but a request must
+        // not go out on one that was opened to a previous socket path
+        if (sock->serverName() == path && sock->state() != QLocalSocket::UnconnectedState) {
+            sock->disconnect(this); // Its spare handlers
+            return sock;
+        }
+        sock->deleteLater();
+    }
+    return nullptr;
+}
+
+void NiriRequestSocket::topUpSpares(const QString& path) {
+    // Only topped up when a request takes one, so a compositor that is gone
+    // costs a failed connect per request rather than a reconnect loop
+    static constexpr qsizetype kSpareConnections = 2;
+    if (!m_preconnect) return;
+
+    // Bounded by count rather than by m_spares.size(), which a synchronous
+    // connect failure shrinks again
+    for (qsizetype i = m_spares.size(); i < kSpareConnections; ++i) {
+        auto* sock = new QLocalSocket(this);
+        connect(sock, &QLocalSocket::disconnected, this, [this, sock]() {
+            dropSpare(sock);
+        });
+        connect(sock, &QLocalSocket::errorOccurred, this, [this, sock](QLocalSocket::LocalSocketError) {
+            dropSpare(sock);
+        });
+        m_spares.append(sock);
+        sock->connectToServer(path);
+    }
+}
+
+void NiriRequestSocket::dropSpare(QLocalSocket* sock) {
+    m_spares.removeOne(sock);
+    sock->disconnect(this);
+    sock->abort();
+    sock->deleteLater();
 }
 
 } // namespace caelestia
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <qbytearray.h>
+#include <qlist.h>
 #include <qlocalsocket.h>
 #include <qobject.h>
 #include <qtimer.h>
@@ -25,7 +26,8 @@ public:
 signals:
     void connected();
     void disconnected();
-    void eventReceived(const QJsonObject& event);
+    /// A single raw event line, e.g. `{"WindowClosed":{"id":3}}`.
+    void eventReceived(const QByteArray& line);
 
 private slots:
     void onConnected();
@@ -40,13 +42,18 @@ private:
     QLocalSocket* m_socket = nullptr;
     QTimer m_reconnectTimer;
     QByteArray m_readBuffer;
+    qsizetype m_scanPos = 0; // Bytes of the partial line in m_readBuffer already searched for '\n'
     int m_reconnectDelay = 1000;
     bool m_handshakeDone = false;
 };
 
 /// Request/action connection to niri's IPC socket.
-/// Each request opens a fresh connection, sends the payload, reads response, closes.
-/// This avoids conflicts with the EventStream socket.
+/// niri answers a single request per connection and then closes it, so every
+/// request gets a connection of its own, separate from the EventStream socket.
+/// To keep connecting off the request path, a couple of spare connections are
+/// opened ahead of time and handed out as requests arrive. Requests are still
+/// sent one at a time, in order, since niri doesn't order requests that arrive
+/// on different connections.
 class NiriRequestSocket : public QObject {
     Q_OBJECT
 
@@ -61,6 +68,10 @@ public:
     /// Send an action (fire-and-forget, response discarded).
     void action(const QByteArray& payload);
 
+    /// Enable or disable keeping spare connections open.
+    void setPreconnect(bool preconnect);
+    [[nodiscard]] bool preconnect() const;
+
 private:
     struct PendingRequest {
         QByteArray payload;
@@ -70,8 +81,16 @@ private:
     void processQueue();
     void startRequest(const PendingRequest& req);
 
+    // Spare connections
+    QLocalSocket* takeConnection(const QString& path);
+    void topUpSpares(const QString& path);
+    void dropSpare(QLocalSocket* sock);
+
     std::deque<PendingRequest> m_queue;
     bool m_busy = false;
+
+    QList<QLocalSocket*> m_spares; // Connecting or connected, not yet used
+    bool m_preconnect = true;
 };
 
 } // namespace caelestia
@@ -0,0 +1,132 @@
+#include "drmgpus.hpp"
+
+#include "pcidevices.hpp"
+
+#include <qdir.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+
+#include <algorithm>
+
+namespace caelestia {
+
+QVariantMap GpuStats::toVariantMap() const {
+    return {
+        { "card", card },
+        { "address", address },
+        { "name", name },
+        { "driver", driver },
+        { "utilization", utilization },
+        { "memoryUsed", memoryUsedKB },
+        { "memoryTotal", memoryTotalKB },
+        { "temperature", temperature },
+        { "power", power },
+        { "coreClock", coreClock },
+        { "memoryClock", memoryClock },
+    };
+}
+
+void DrmGpus::resolve() {
+    m_cards.clear();
+
+    const QList<pci::Device> devices = pci::displayDevices();
+
+    const QDir drmDir("/sys/class/drm");
+    for (const QString& name : drmDir.entryList({ "card*" }, QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        if (name.contains('-')) continue; // Connectors, e.g. card1-DP-1
+
+        const QString cardPath = drmDir.absoluteFilePath(name);
+        const QString address = QFileInfo(QFileInfo(cardPath + "/device").canonicalFilePath()).fileName();
+        const auto dev = std::ranges::find(devices, address, &pci::Device::address);
+        if (dev == devices.end()) continue; // Not a PCI GPU, e.g. a display-only SoC block
+
+        // Only attributes that exist get a path, so sample() skips the rest
+        // instead of failing an open() on them every tick
+        const auto attr = [](procfs::ProcFile& file, const QString& path) {
+            if (QFile::exists(path)) file.setPath(path.toStdString());
+            return file.isValid();
+        };
+
+        Card card;
+        card.stats.card = name;
+        card.stats.address = address;
+        card.stats.name = pci::marketingName(dev->vendor, dev->device);
+        card.stats.driver = dev->driver;
+        card.stats.vendor = dev->vendor;
+
+        attr(card.busy, dev->sysfsPath + "/gpu_busy_percent");
+        attr(card.vramUsed, dev->sysfsPath + "/mem_info_vram_used");
+        attr(card.vramTotal, dev->sysfsPath + "/mem_info_vram_total");
+
+        const QDir hwmonDir(dev->sysfsPath + "/hwmon");
+        const QStringList hwmons = hwmonDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+        if (!hwmons.isEmpty()) {
+            const QString hwmon = hwmonDir.absoluteFilePath(hwmons.first());
+            attr(card.temp, hwmon + "/temp1_input");
+            if (!attr(card.power, hwmon + "/power1_average")) attr(card.power, hwmon + "/power1_input");
+            attr(card.coreClock, hwmon + "/freq1_input"); // sclk
+            attr(card.memoryClock, hwmon + "/freq2_input"); // mclk
+        }
+        if (!card.coreClock.isValid() && attr(card.coreClock, cardPath + "/gt_cur_freq_mhz")) {
+            card.coreClockMHz = true;
+        }
+
+        m_cards.push_back(std::move(card));
+    }
+}
+
+void DrmGpus::sample() {
+    for (Card& card : m_cards) {
+        GpuStats& s = card.stats;
+        qint64 value = 0;
+        double real = 0;
+
+        if (card.busy.isValid() && card.busy.readDouble(real)) s.utilization = real / 100.0;
+        if (card.vramUsed.isValid() && card.vramUsed.readInt(value)) s.memoryUsedKB = value / 1024;
+        if (card.vramTotal.isValid() && card.vramTotal.readInt(value)) s.memoryTotalKB = value / 1024;
+        if (card.temp.isValid() && card.temp.readDouble(real)) s.temperature = real / 1000.0;
+        if (card.power.isValid() && card.power.readDouble(real)) s.power = real / 1e6; // µW
+        if (card.coreClock.isValid() && card.coreClock.readDouble(real)) {
+            s.coreClock = card.coreClockMHz ? real : real / 1e6;
+        }
+        if (card.memoryClock.isValid() && card.memoryClock.readDouble(real)) s.memoryClock = real / 1e6;
+    }
+}
+
+QList<GpuStats> DrmGpus::stats() const {
+    QList<GpuStats> out;
+    out.reserve(static_cast<qsizetype>(m_cards.size()));
+    for (const Card& card : m_cards) {
+        out.append(card.stats);
+    }
+    return out;
+}
+
+bool DrmGpus::reportsUtilization() const {
+    return std::ranges::any_of(m_cards, [](const Card& card) {
+        return card.busy.isValid();
+    });
+}
+
+double DrmGpus::meanUtilization() const {
+    double total = 0;
+    int count = 0;
+    for (const Card& card : m_cards) {
+        if (!card.busy.isValid()) continue;
+        total += card.stats.utilization;
+        ++count;
+    }
+    return count > 0 ? total / count : -1;
+}
+
+double DrmGpus::temperature() const {
+    for (const Card& card : m_cards) {
+        if (card.temp.isValid() && card.busy.isValid()) return card.stats.temperature;
+    }
+    for (const Card& card : m_cards) {
+        if (card.temp.isValid()) return card.stats.temperature;
+    }
+    return 0;
+}
+
+} // namespace caelestia
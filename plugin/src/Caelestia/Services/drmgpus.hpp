@@ -0,0 +1,67 @@
+#pragma once
+
+#include "procfs.hpp"
+
+#include <qlist.h>
+#include <qstring.h>
+#include <qvariant.h>
+
+#include <vector>
+
+namespace caelestia {
+
+/// One GPU as seen through DRM sysfs and its hwmon node. Readings the driver
+/// doesn't expose stay 0 (amdgpu reports everything below; i915/xe only clocks;
+/// the NVIDIA driver none of it, see NvidiaTelemetry).
+struct GpuStats {
+    QString card; // e.g. card1
+    QString address; // PCI address
+    QString name;
+    QString driver;
+    quint16 vendor = 0;
+    double utilization = 0; // 0-1
+    qint64 memoryUsedKB = 0;
+    qint64 memoryTotalKB = 0;
+    double temperature = 0; // °C
+    double power = 0; // W
+    double coreClock = 0; // MHz
+    double memoryClock = 0; // MHz
+
+    [[nodiscard]] QVariantMap toVariantMap() const;
+};
+
+/// Per-card DRM metrics. Cards and the sysfs/hwmon files behind each metric
+/// are found once by resolve(); sample() only re-reads the already open
+/// files.
+class DrmGpus {
+public:
+    void resolve();
+    void sample();
+
+    [[nodiscard]] bool isEmpty() const { return m_cards.empty(); }
+    [[nodiscard]] bool reportsUtilization() const;
+    [[nodiscard]] QList<GpuStats> stats() const;
+
+    /// Mean busy fraction over the cards that report one, or -1 if none do.
+    [[nodiscard]] double meanUtilization() const;
+    /// Temperature of the first card reporting one, preferring cards that also
+    /// report utilization.
+    [[nodiscard]] double temperature() const;
+
+private:
+    struct Card {
+        GpuStats stats;
+        procfs::ProcFile busy;
+        procfs::ProcFile vramUsed;
+        procfs::ProcFile vramTotal;
+        procfs::ProcFile temp;
+        procfs::ProcFile power;
+        procfs::ProcFile coreClock;
+        procfs::ProcFile memoryClock;
+        bool coreClockMHz = false; // i915 reports MHz, hwmon Hz
+    };
+
+    std::vector<Card> m_cards;
+};
+
+} // namespace caelestia
@@ -0,0 +1,209 @@
+#include "mounttable.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <sys/statvfs.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+namespace caelestia {
+
+namespace {
+
+constexpr auto kRemoteStatfsTimeout = std::chrono::milliseconds(500);
+
+// Filesystems that answer statfs() over the network, which can stop responding
+constexpr std::string_view kRemoteFilesystems[] = {
+    "nfs",
+    "nfs4",
+    "cifs",
+    "smb3",
+    "ceph",
+    "glusterfs",
+    "9p",
+    "afs",
+    "davfs",
+    "fuse.sshfs",
+    "fuse.rclone",
+};
+
+// statfs() on a FUSE mount (fuse, fuse.*, fuseblk) is answered by its
+// daemon, which can wedge just like a server, whatever its source looks like
+bool isFuse(std::string_view fstype) {
+    return fstype.starts_with("fuse");
+}
+
+// Storage-backed filesystems whose source isn't a device path
+constexpr std::string_view kPoolFilesystems[] = {
+    "zfs",
+    "bcachefs",
+};
+
+// mountinfo escapes space, tab, newline and backslash as \ooo
+std::string unescape(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 3 < text.size()) {
+            const auto digit = [](char c) {
+                return c >= '0' && c <= '7';
+            };
+            if (digit(text[i + 1]) && digit(text[i + 2]) && digit(text[i + 3])) {
+                out += static_cast<char>((text[i + 1] - '0') * 64 + (text[i + 2] - '0') * 8 + (text[i + 3] - '0'));
+                i += 3;
+                continue;
+            }
+        }
+        out += text[i];
+    }
+    return out;
+}
+
+bool isUnder(std::string_view path, std::string_view dir) {
+    return path.starts_with(dir) && (path.size() == dir.size() || path[dir.size()] == '/');
+}
+
+} // namespace
+
+MountTable::MountTable()
+    : m_watchFd(open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC)) {}
+
+MountTable::~MountTable() {
+    if (m_watchFd >= 0) ::close(m_watchFd);
+}
+
+bool MountTable::update() {
+    if (m_tableChanged) {
+        m_tableChanged = false;
+        readTable();
+    }
+    readUsage();
+
+    QList<MountStats> mounts;
+    mounts.reserve(static_cast<qsizetype>(m_entries.size()));
+    for (const Mount& entry : m_entries) {
+        mounts.append(entry.stats);
+    }
+    if (mounts == m_mounts) return false;
+    m_mounts = mounts;
+    return true;
+}
+
+void MountTable::readTable() {
+    std::string_view text = m_mountinfo.read();
+
+    std::vector<Mount> entries;
+    std::vector<std::string_view> seenDevices;
+    std::string_view line;
+    while (procfs::nextLine(text, line)) {
+        // "36 35 98:0 /mnt1 /mnt/parent rw,noatime master:1 - ext3 /dev/root rw,errors=continue"
+        procfs::nextField(line); // mount id
+        procfs::nextField(line); // parent id
+        const std::string_view device = procfs::nextField(line); // major:minor
+        procfs::nextField(line); // root
+        const std::string path = unescape(procfs::nextField(line));
+        const std::string_view options = procfs::nextField(line);
+
+        std::string_view field;
+        do {
+            field = procfs::nextField(line); // Optional tagged fields up to the separator
+        } while (!field.empty() && field != "-");
+        const std::string_view fstype = procfs::nextField(line);
+        const std::string_view source = procfs::nextField(line);
+        if (fstype.empty()) continue;
+
+        if (options.starts_with("ro") && (options.size() == 2 || options[2] == ',')) continue;
+        if (isUnder(path, "/proc") || isUnder(path, "/sys") || isUnder(path, "/dev")) continue;
+
+        const bool network = std::ranges::find(kRemoteFilesystems, fstype) != std::end(kRemoteFilesystems);
+        const bool storage = source.starts_with('/') ||
+                             std::ranges::find(kPoolFilesystems, fstype) != std::end(kPoolFilesystems);
+        if (!network && !storage) continue; // tmpfs, overlay, cgroup2, portals, ...
+
+        // Bind mounts and btrfs subvolumes share the filesystem of an earlier
+        // mount; counting them again would double its size. mountinfo is in
+        // mount order, so the first one seen is the topmost, e.g. / over /home
+        if (std::ranges::find(seenDevices, device) != seenDevices.end()) continue;
+        seenDevices.push_back(device);
+
+        // Keep what is already known about mounts that are still there,
+        // including an outstanding statfs
+        const auto existing = std::ranges::find(m_entries, path, &Mount::path);
+        if (existing != m_entries.end()) {
+            entries.push_back(std::move(*existing));
+            continue;
+        }
+
+        Mount entry;
+        entry.path = path;
+        entry.remote = network || isFuse(fstype); // statfs off the sampler thread
+        entry.stats.device = QString::fromUtf8(source.data(), static_cast<qsizetype>(source.size()));
+        entry.stats.mount = QString::fromStdString(path);
+        entry.stats.fstype = QString::fromUtf8(fstype.data(), static_cast<qsizetype>(fstype.size()));
+        entries.push_back(std::move(entry));
+    }
+
+    // Entries left behind were unmounted. Dropping a future tied to a hung
+    // statfs doesn't wait for it; the detached thread finishes on its own
+    m_entries = std::move(entries);
+}
+
+void MountTable::readUsage() {
+    const auto apply = [](MountStats& stats, const Usage& usage) {
+        stats.size = usage.size;
+        stats.used = usage.size - usage.free;
+        stats.avail = usage.avail;
+        const qint64 usable = stats.used + stats.avail; // Excludes blocks reserved for root, like df
+        stats.percent = usable > 0 ? static_cast<double>(stats.used) / static_cast<double>(usable) : 0;
+    };
+
+    std::vector<Mount*> started;
+    for (Mount& entry : m_entries) {
+        if (!entry.remote) {
+            if (const auto usage = queryUsage(entry.path)) apply(entry.stats, *usage);
+            continue;
+        }
+
+        if (entry.pending.valid()) {
+            // Hung on an earlier pass; already waited for once, so only look
+            if (entry.pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) continue;
+            if (const auto usage = entry.pending.get()) apply(entry.stats, *usage);
+            entry.stats.responsive = true;
+            continue;
+        }
+
+        std::promise<std::optional<Usage>> promise;
+        entry.pending = promise.get_future();
+        std::thread([path = entry.path, result = std::move(promise)]() mutable {
+            result.set_value(queryUsage(path));
+        }).detach();
+        started.push_back(&entry);
+    }
+
+    // One deadline for the calls started now, so several dead servers cost
+    // one timeout rather than one each, and a server that stays dead costs
+    // it only once
+    const auto deadline = std::chrono::steady_clock::now() + kRemoteStatfsTimeout;
+    for (Mount* entry : started) {
+        if (entry->pending.wait_until(deadline) != std::future_status::ready) {
+            entry->stats.responsive = false;
+            continue;
+        }
+        if (const auto usage = entry->pending.get()) apply(entry->stats, *usage);
+        entry->stats.responsive = true;
+    }
+}
+
+std::optional<MountTable::Usage> MountTable::queryUsage(const std::string& path) {
+    struct statvfs st {};
+    if (statvfs(path.c_str(), &st) != 0) return std::nullopt;
+
+    const auto bytes = [&st](fsblkcnt_t blocks) {
+        return static_cast<qint64>(blocks * st.f_frsize);
+    };
+    return Usage{ bytes(st.f_blocks), bytes(st.f_bfree), bytes(st.f_bavail) };
+}
+
+} // namespace caelestia
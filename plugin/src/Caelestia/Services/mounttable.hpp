@@ -0,0 +1,80 @@
+#pragma once
+
+#include "procfs.hpp"
+
+#include <qlist.h>
+#include <qstring.h>
+
+#include <future>
+#include <optional>
+#include <vector>
+
+namespace caelestia {
+
+/// Space on one mounted filesystem, in bytes, as df reports it.
+struct MountStats {
+    QString device;
+    QString mount;
+    QString fstype;
+    qint64 size = 0;
+    qint64 used = 0;
+    qint64 avail = 0; // Available to unprivileged users
+    double percent = 0; // used / (used + avail), 0-1
+    bool responsive = true; // False while a statfs is hung, e.g. on a dead NFS server
+
+    bool operator==(const MountStats& other) const = default;
+};
+
+/// Writable, storage-backed mounts and their usage. The mount list is only
+/// re-parsed after the kernel flags /proc/self/mountinfo as changed (POLLPRI
+/// on watchFd()); usage is refreshed on every update(), so callers decide how
+/// often that is.
+///
+/// statfs() on a network or FUSE filesystem blocks for as long as the server
+/// or daemon doesn't answer, so those run on a detached thread and are waited
+/// for with a timeout. A mount whose statfs hasn't returned keeps its last
+/// known usage and is marked unresponsive; later updates only check whether
+/// the call has completed, without waiting again or starting another.
+class MountTable {
+public:
+    MountTable();
+    ~MountTable();
+
+    MountTable(const MountTable&) = delete;
+    MountTable& operator=(const MountTable&) = delete;
+
+    /// Polls with POLLPRI when the mount table changes.
+    [[nodiscard]] int watchFd() const { return m_watchFd; }
+    void invalidate() { m_tableChanged = true; }
+
+    /// Re-reads usage, and the mount list if it changed. Returns whether
+    /// mounts() changed.
+    bool update();
+    [[nodiscard]] const QList<MountStats>& mounts() const { return m_mounts; }
+
+private:
+    struct Usage {
+        qint64 size;
+        qint64 free;
+        qint64 avail;
+    };
+    struct Mount {
+        MountStats stats;
+        std::string path;
+        bool remote = false; // Network or FUSE, so statfs() may hang
+        std::future<std::optional<Usage>> pending; // Outstanding remote statfs
+    };
+
+    void readTable();
+    void readUsage();
+    static std::optional<Usage> queryUsage(const std::string& path);
+
+    procfs::ProcFile m_mountinfo{ "/proc/self/mountinfo" };
+    int m_watchFd = -1;
+    bool m_tableChanged = true;
+
+    std::vector<Mount> m_entries;
+    QList<MountStats> m_mounts;
+};
+
+} // namespace caelestia
@@ -0,0 +1,213 @@
+#include "nvidiatelemetry.hpp"
+
+#include <qdebug.h>
+#include <qlist.h>
+#include <qprocess.h>
+
+#include <dlfcn.h>
+
+namespace caelestia {
+
+// Just enough of nvml.h to load the library at runtime, so neither the
+// headers nor the library are needed to build
+struct NvidiaTelemetry::Nvml {
+    using Return = int; // nvmlReturn_t, 0 is NVML_SUCCESS
+    using Device = void*;
+    struct Utilization {
+        unsigned int gpu;
+        unsigned int memory;
+    };
+    struct Memory {
+        unsigned long long total;
+        unsigned long long free;
+        unsigned long long used;
+    };
+
+    void* lib = nullptr;
+    Device device = nullptr;
+
+    Return (*init)() = nullptr;
+    Return (*shutdown)() = nullptr;
+    Return (*handleByIndex)(unsigned int, Device*) = nullptr;
+    Return (*handleByBusId)(const char*, Device*) = nullptr;
+    Return (*utilization)(Device, Utilization*) = nullptr;
+    Return (*temperature)(Device, int, unsigned int*) = nullptr;
+    Return (*memory)(Device, Memory*) = nullptr;
+    Return (*powerUsage)(Device, unsigned int*) = nullptr; // mW
+
+    ~Nvml() {
+        if (shutdown && device) shutdown();
+        if (lib) dlclose(lib);
+    }
+
+    template <typename Fn>
+    bool resolve(Fn& fn, const char* name) {
+        fn = reinterpret_cast<Fn>(dlsym(lib, name));
+        return fn != nullptr;
+    }
+};
+
+NvidiaTelemetry::NvidiaTelemetry(QObject* parent)
+    : QObject(parent) {}
+
+NvidiaTelemetry::~NvidiaTelemetry() {
+    close();
+}
+
+bool NvidiaTelemetry::open(const QString& busId, int intervalMs) {
+    close();
+    m_busId = busId;
+    m_intervalMs = intervalMs;
+
+    if (openNvml(busId)) {
+        m_backend = Backend::Nvml;
+    } else if (startSmi()) {
+        m_backend = Backend::NvidiaSmi;
+    } else {
+        qWarning() << "NvidiaTelemetry::open: neither NVML nor nvidia-smi is available";
+        return false;
+    }
+    return true;
+}
+
+void NvidiaTelemetry::close() {
+    delete m_nvml;
+    m_nvml = nullptr;
+
+    if (m_smi) {
+        m_smi->disconnect(this);
+        m_smi->kill();
+        m_smi->waitForFinished(500);
+        delete m_smi;
+        m_smi = nullptr;
+    }
+
+    m_backend = Backend::None;
+    m_last = {};
+}
+
+void NvidiaTelemetry::setInterval(int intervalMs) {
+    if (m_intervalMs == intervalMs) return;
+    m_intervalMs = intervalMs;
+
+    // --loop-ms is fixed for the life of the child
+    if (m_backend == Backend::NvidiaSmi) startSmi();
+}
+
+NvidiaSample NvidiaTelemetry::latest() {
+    if (m_backend == Backend::Nvml) {
+        NvidiaSample sample;
+        Nvml::Utilization util{};
+        if (m_nvml->utilization(m_nvml->device, &util) != 0) return sample;
+
+        sample.valid = true;
+        sample.utilization = util.gpu / 100.0;
+
+        unsigned int temp = 0;
+        if (m_nvml->temperature(m_nvml->device, 0, &temp) == 0) sample.temperature = temp; // NVML_TEMPERATURE_GPU
+
+        Nvml::Memory mem{};
+        if (m_nvml->memory(m_nvml->device, &mem) == 0) {
+            sample.memoryUsedKB = static_cast<qint64>(mem.used / 1024);
+            sample.memoryTotalKB = static_cast<qint64>(mem.total / 1024);
+        }
+
+        unsigned int milliwatts = 0;
+        if (m_nvml->powerUsage && m_nvml->powerUsage(m_nvml->device, &milliwatts) == 0) {
+            sample.power = milliwatts / 1000.0;
+        }
+        return sample;
+    }
+
+    if (m_backend == Backend::NvidiaSmi && m_smi->state() == QProcess::NotRunning) {
+        // The driver was reloaded or the child died; retry, but don't respawn every tick
+        m_last = {};
+        if (m_sinceStart.hasExpired(10000)) startSmi();
+    }
+
+    return m_last;
+}
+
+bool NvidiaTelemetry::openNvml(const QString& busId) {
+    auto* nvml = new Nvml;
+    nvml->lib = dlopen("libnvidia-ml.so.1", RTLD_NOW | RTLD_LOCAL);
+
+    const bool resolved = nvml->lib && nvml->resolve(nvml->init, "nvmlInit_v2") &&
+                          nvml->resolve(nvml->shutdown, "nvmlShutdown") &&
+                          nvml->resolve(nvml->handleByIndex, "nvmlDeviceGetHandleByIndex_v2") &&
+                          nvml->resolve(nvml->handleByBusId, "nvmlDeviceGetHandleByPciBusId_v2") &&
+                          nvml->resolve(nvml->utilization, "nvmlDeviceGetUtilizationRates") &&
+                          nvml->resolve(nvml->temperature, "nvmlDeviceGetTemperature") &&
+                          nvml->resolve(nvml->memory, "nvmlDeviceGetMemoryInfo");
+    if (!resolved || nvml->init() != 0) {
+        nvml->shutdown = nullptr; // Not initialised, so nothing to shut down
+        delete nvml;
+        return false;
+    }
+    nvml->resolve(nvml->powerUsage, "nvmlDeviceGetPowerUsage"); // Optional
+
+    Nvml::Device device = nullptr;
+    const QByteArray id = busId.toLatin1();
+    if ((id.isEmpty() || nvml->handleByBusId(id.constData(), &device) != 0) &&
+        nvml->handleByIndex(0, &device) != 0) {
+        nvml->shutdown();
+        nvml->shutdown = nullptr;
+        delete nvml;
+        return false;
+    }
+
+    nvml->device = device;
+    m_nvml = nvml;
+    return true;
+}
+
+bool NvidiaTelemetry::startSmi() {
+    if (m_smi) {
+        m_smi->disconnect(this);
+        m_smi->kill();
+        m_smi->waitForFinished(500);
+    } else {
+        m_smi = new QProcess(this);
+    }
+
+    QStringList args{ "--query-gpu=utilization.gpu,temperature.gpu,memory.used,memory.total,power.draw",
+        "--format=csv,noheader,nounits", QString("--loop-ms=%1").arg(qMax(m_intervalMs, 100)) };
+    if (!m_busId.isEmpty()) args << "-i" << m_busId;
+
+    connect(m_smi, &QProcess::readyReadStandardOutput, this, &NvidiaTelemetry::readSmi);
+    m_smi->setStandardErrorFile(QProcess::nullDevice());
+    m_smi->start(qEnvironmentVariable("CAELESTIA_NVIDIA_SMI", "nvidia-smi"), args, QIODevice::ReadOnly);
+    m_sinceStart.start();
+    return m_smi->waitForStarted(1000);
+}
+
+void NvidiaTelemetry::readSmi() {
+    while (m_smi->canReadLine()) {
+        parseSmiLine(QByteArrayView(m_smi->readLine()).trimmed());
+    }
+}
+
+void NvidiaTelemetry::parseSmiLine(QByteArrayView line) {
+    // "45, 62, 1234, 8192, 85.20" - unsupported fields read "[N/A]" or "[Not Supported]"
+    const QList<QByteArray> fields = line.toByteArray().split(',');
+    if (fields.size() != 5) return;
+
+    const auto field = [&fields](qsizetype i) {
+        bool ok = false;
+        const double value = fields.at(i).trimmed().toDouble(&ok);
+        return ok ? value : 0.0;
+    };
+
+    bool ok = false;
+    const double util = fields.at(0).trimmed().toDouble(&ok);
+    if (!ok) return;
+
+    m_last.valid = true;
+    m_last.utilization = util / 100.0;
+    m_last.temperature = field(1);
+    m_last.memoryUsedKB = static_cast<qint64>(field(2) * 1024.0); // MiB
+    m_last.memoryTotalKB = static_cast<qint64>(field(3) * 1024.0);
+    m_last.power = field(4);
+}
+
+} // namespace caelestia
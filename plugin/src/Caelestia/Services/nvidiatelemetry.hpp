@@ -0,0 +1,75 @@
+#pragma once
+
+#include <qbytearray.h>
+#include <qelapsedtimer.h>
+#include <qobject.h>
+#include <qstring.h>
+
+class QProcess;
+
+namespace caelestia {
+
+/// Latest readings for one NVIDIA GPU. Fields the driver doesn't report
+/// (e.g. power on some laptop parts) stay 0.
+struct NvidiaSample {
+    bool valid = false;
+    double utilization = 0; // 0-1
+    double temperature = 0; // °C
+    qint64 memoryUsedKB = 0;
+    qint64 memoryTotalKB = 0;
+    double power = 0; // W
+};
+
+/// Long-lived telemetry channel for an NVIDIA GPU, so sampling never forks.
+/// Uses NVML when libnvidia-ml can be loaded, polled in-process on each
+/// latest() call. Otherwise runs one `nvidia-smi --loop-ms` child for as long
+/// as the channel is open and parses its CSV stream as it arrives; latest()
+/// then returns the last complete line. Lives on, and must be used from,
+/// the sampler thread.
+///
+/// The nvidia-smi binary can be overridden with $CAELESTIA_NVIDIA_SMI, e.g.
+/// to point at a script that prints canned output.
+class NvidiaTelemetry : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Backend {
+        None,
+        Nvml,
+        NvidiaSmi,
+    };
+
+    explicit NvidiaTelemetry(QObject* parent = nullptr);
+    ~NvidiaTelemetry() override;
+
+    /// Opens the channel for the GPU at PCI `busId` (e.g. "0000:01:00.0"),
+    /// or the first GPU if empty. Returns false if neither backend works.
+    bool open(const QString& busId, int intervalMs);
+    void close();
+
+    /// Changes how often the nvidia-smi stream reports; NVML is polled on
+    /// demand and ignores this.
+    void setInterval(int intervalMs);
+
+    [[nodiscard]] Backend backend() const { return m_backend; }
+    NvidiaSample latest();
+
+private:
+    struct Nvml;
+
+    bool openNvml(const QString& busId);
+    bool startSmi();
+    void readSmi();
+    void parseSmiLine(QByteArrayView line);
+
+    Backend m_backend = Backend::None;
+    Nvml* m_nvml = nullptr;
+
+    QProcess* m_smi = nullptr;
+    QString m_busId;
+    int m_intervalMs = 2000;
+    QElapsedTimer m_sinceStart;
+    NvidiaSample m_last;
+};
+
+} // namespace caelestia
@@ -0,0 +1,116 @@
+#include "pcidevices.hpp"
+
+#include "procfs.hpp"
+
+#include <qbytearray.h>
+#include <qdir.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qregularexpression.h>
+
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+
+namespace caelestia::pci {
+
+namespace {
+
+bool readHex(const QString& path, quint32& out) {
+    procfs::ProcFile file(path.toStdString());
+    std::string_view text = procfs::trimmed(file.read());
+    if (text.starts_with("0x")) text.remove_prefix(2);
+    if (text.empty()) return false;
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out, 16);
+    return ec == std::errc();
+}
+
+bool parseHexId(std::string_view text, quint16& out) {
+    if (text.size() < 4) return false;
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + 4, out, 16);
+    return ec == std::errc() && ptr == text.data() + 4;
+}
+
+} // namespace
+
+QList<Device> displayDevices() {
+    QList<Device> devices;
+
+    const QDir dir("/sys/bus/pci/devices");
+    for (const QString& address : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        Device d;
+        d.address = address;
+        d.sysfsPath = dir.absoluteFilePath(address);
+
+        quint32 value = 0;
+        if (!readHex(d.sysfsPath + "/class", value) || (value >> 16) != 0x03) continue;
+        d.classCode = value;
+        if (readHex(d.sysfsPath + "/vendor", value)) d.vendor = static_cast<quint16>(value);
+        if (readHex(d.sysfsPath + "/device", value)) d.device = static_cast<quint16>(value);
+        d.bootVga = readHex(d.sysfsPath + "/boot_vga", value) && value == 1;
+
+        const QFileInfo driver(d.sysfsPath + "/driver");
+        if (driver.isSymLink()) d.driver = QFileInfo(driver.symLinkTarget()).fileName();
+
+        devices.append(d);
+    }
+
+    std::ranges::stable_sort(devices, [](const Device& a, const Device& b) {
+        return a.bootVga > b.bootVga;
+    });
+    return devices;
+}
+
+QString deviceName(quint16 vendor, quint16 device) {
+    static constexpr const char* paths[] = {
+        "/usr/share/hwdata/pci.ids",
+        "/usr/share/misc/pci.ids",
+        "/usr/share/pci.ids",
+    };
+
+    QFile file;
+    for (const char* path : paths) {
+        file.setFileName(path);
+        if (file.open(QIODevice::ReadOnly)) break;
+    }
+    if (!file.isOpen()) return {};
+
+    // Vendors are unindented lines "vvvv  Name", their devices follow as
+    // "\tdddd  Name" and subsystems as "\t\t...". Comments start with '#'.
+    // Read whole lines: a line split by a fixed buffer would have its tail
+    // taken for a vendor line.
+    bool inVendor = false;
+    while (!file.atEnd()) {
+        const QByteArray raw = file.readLine();
+        std::string_view line(raw.constData(), static_cast<std::size_t>(raw.size()));
+        if (line.empty() || line.front() == '#' || line.front() == '\n') continue;
+
+        quint16 id = 0;
+        if (line.front() != '\t') {
+            // The next unindented line ends our vendor's device list
+            if (inVendor) break;
+            inVendor = parseHexId(line, id) && id == vendor;
+        } else if (inVendor && line.size() > 1 && line[1] != '\t') {
+            line.remove_prefix(1);
+            if (parseHexId(line, id) && id == device) {
+                const std::string_view name = procfs::trimmed(line.substr(4));
+                return QString::fromUtf8(name.data(), static_cast<qsizetype>(name.size()));
+            }
+        }
+    }
+
+    return {};
+}
+
+QString marketingName(quint16 vendor, quint16 device) {
+    QString name = deviceName(vendor, device);
+    const auto open = name.lastIndexOf('[');
+    const auto close = name.lastIndexOf(']');
+    if (open >= 0 && close > open) name = name.mid(open + 1, close - open - 1);
+
+    static const QRegularExpression vendorRe(
+        "(?i)NVIDIA GeForce |NVIDIA |GeForce |AMD Radeon |AMD |Intel |\\(R\\)|\\(TM\\)|Graphics|Corporation");
+    return name.replace(vendorRe, "").replace("  ", " ").trimmed();
+}
+
+} // namespace caelestia::pci
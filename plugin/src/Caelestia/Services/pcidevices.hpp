@@ -0,0 +1,37 @@
+#pragma once
+
+#include <qlist.h>
+#include <qstring.h>
+
+namespace caelestia::pci {
+
+/// A PCI function as described by /sys/bus/pci/devices/<address>.
+struct Device {
+    QString address; // e.g. 0000:03:00.0
+    QString sysfsPath;
+    quint32 classCode = 0; // class << 16 | subclass << 8 | prog-if
+    quint16 vendor = 0;
+    quint16 device = 0;
+    QString driver; // Bound kernel driver, empty if none
+    bool bootVga = false;
+};
+
+constexpr quint16 VendorNvidia = 0x10de;
+constexpr quint16 VendorAmd = 0x1002;
+constexpr quint16 VendorIntel = 0x8086;
+
+/// Display controllers (PCI base class 0x03), in bus order, with the boot VGA
+/// device first.
+QList<Device> displayDevices();
+
+/// Looks the device up in the system's pci.ids, as lspci would. Returns an
+/// empty string if no database is installed or the id isn't listed.
+QString deviceName(quint16 vendor, quint16 device);
+
+/// deviceName() reduced to what a user would call the card: the bracketed
+/// marketing name if there is one (pci.ids names read like
+/// "Navi 21 [Radeon RX 6800/6800 XT / 6900 XT]"), without vendor prefixes
+/// and trademark marks.
+QString marketingName(quint16 vendor, quint16 device);
+
+} // namespace caelestia::pci
@@ -0,0 +1,122 @@
+#include "pressure.hpp"
+
+#include <qdebug.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+namespace caelestia {
+
+namespace {
+
+// Unprivileged triggers need a window that is a multiple of 2 s
+constexpr qint64 kTriggerWindowUs = 2'000'000;
+
+} // namespace
+
+QVariantMap PressureStats::toVariantMap() const {
+    return {
+        { "some10", some10 },
+        { "some60", some60 },
+        { "some300", some300 },
+        { "full10", full10 },
+        { "full60", full60 },
+        { "full300", full300 },
+    };
+}
+
+Pressure::Pressure() {
+    for (int i = 0; i < ResourceCount; ++i) {
+        m_files[i].setPath(std::string("/proc/pressure/") + name(static_cast<Resource>(i)));
+    }
+    m_triggers.fill(-1);
+}
+
+Pressure::~Pressure() {
+    closeTriggers();
+}
+
+bool Pressure::isAvailable() const {
+    return access("/proc/pressure/cpu", R_OK) == 0;
+}
+
+void Pressure::sample() {
+    for (int i = 0; i < ResourceCount; ++i) {
+        std::string_view text = m_files[i].read();
+        PressureStats& stats = m_stats[i];
+
+        // "some avg10=0.12 avg60=0.05 avg300=0.01 total=123456"
+        // "full avg10=0.00 avg60=0.00 avg300=0.00 total=4567"
+        std::string_view line;
+        while (procfs::nextLine(text, line)) {
+            const std::string_view kind = procfs::nextField(line);
+            std::array<double*, 3> avgs{};
+            if (kind == "some") {
+                avgs = { &stats.some10, &stats.some60, &stats.some300 };
+            } else if (kind == "full") {
+                avgs = { &stats.full10, &stats.full60, &stats.full300 };
+            } else {
+                continue;
+            }
+
+            // The averages are percentages, in the order of the fields
+            for (double* avg : avgs) {
+                const std::string_view pair = procfs::nextField(line);
+                const auto eq = pair.find('=');
+                double value = 0;
+                if (eq != std::string_view::npos && procfs::parseDouble(pair.substr(eq + 1), value)) {
+                    *avg = value / 100.0;
+                }
+            }
+        }
+    }
+}
+
+bool Pressure::setThreshold(double threshold) {
+    closeTriggers();
+    if (threshold <= 0) return true;
+
+    const auto stallUs = static_cast<qint64>(qMin(threshold, 1.0) * static_cast<double>(kTriggerWindowUs));
+    const std::string trigger = "some " + std::to_string(stallUs) + " " + std::to_string(kTriggerWindowUs);
+
+    bool armed = false;
+    for (int i = 0; i < ResourceCount; ++i) {
+        // A trigger lives as long as the descriptor it was written to
+        const std::string path = m_files[i].path();
+        const int fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) continue;
+        if (write(fd, trigger.c_str(), trigger.size() + 1) < 0) {
+            qWarning() << "Pressure::setThreshold: unable to arm trigger on" << path.c_str() << "-"
+                       << std::strerror(errno);
+            ::close(fd);
+            continue;
+        }
+        m_triggers[i] = fd;
+        armed = true;
+    }
+    return armed;
+}
+
+const char* Pressure::name(Resource resource) {
+    switch (resource) {
+    case Cpu:
+        return "cpu";
+    case Memory:
+        return "memory";
+    case Io:
+        return "io";
+    }
+    return "";
+}
+
+void Pressure::closeTriggers() {
+    for (int& fd : m_triggers) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+}
+
+} // namespace caelestia
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "procfs.hpp"
+
+#include <qvariant.h>
+
+#include <array>
+
+namespace caelestia {
+
+/// Pressure stall information for one resource: the share of wall time in
+/// which some (or all non-idle) tasks were stalled waiting on it, averaged
+/// over 10 s, 60 s and 300 s, each 0-1.
+struct PressureStats {
+    double some10 = 0;
+    double some60 = 0;
+    double some300 = 0;
+    double full10 = 0; // Not reported for CPU before Linux 5.13
+    double full60 = 0;
+    double full300 = 0;
+
+    bool operator==(const PressureStats& other) const = default;
+    [[nodiscard]] QVariantMap toVariantMap() const;
+};
+
+/// Reads /proc/pressure/{cpu,memory,io} and optionally arms kernel PSI
+/// triggers on them, so a stall can be noticed without polling: each
+/// trigger's fd polls with POLLPRI when the "some" stall time within a 2 s
+/// window crosses the threshold, at most once per window.
+class Pressure {
+public:
+    enum Resource {
+        Cpu,
+        Memory,
+        Io,
+    };
+    static constexpr int ResourceCount = 3;
+
+    Pressure();
+    ~Pressure();
+
+    Pressure(const Pressure&) = delete;
+    Pressure& operator=(const Pressure&) = delete;
+
+    /// False on kernels built without PSI or booted with psi=0.
+    [[nodiscard]] bool isAvailable() const;
+    void sample();
+    [[nodiscard]] const PressureStats& stats(Resource resource) const { return m_stats[resource]; }
+
+    /// Arms a trigger per resource at `threshold` (0-1) of the window, or
+    /// disarms them if 0. Returns false if no trigger could be armed, e.g.
+    /// unprivileged before Linux 6.5.
+    bool setThreshold(double threshold);
+    [[nodiscard]] int triggerFd(Resource resource) const { return m_triggers[resource]; }
+
+    static const char* name(Resource resource);
+
+private:
+    void closeTriggers();
+
+    std::array<procfs::ProcFile, ResourceCount> m_files;
+    std::array<PressureStats, ResourceCount> m_stats;
+    std::array<int, ResourceCount> m_triggers;
+};
+
+} // namespace caelestia
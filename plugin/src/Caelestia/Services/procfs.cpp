@@ -0,0 +1,168 @@
+#include "procfs.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <utility>
+
+namespace caelestia::procfs {
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// proc files report a size of 0, so read until EOF and grow as needed
+static bool readToEnd(int fd, std::vector<char>& buffer, std::size_t& len) {
+    if (buffer.empty()) buffer.resize(4096);
+    len = 0;
+    for (;;) {
+        const ssize_t n = ::pread(fd, buffer.data() + len, buffer.size() - len, static_cast<off_t>(len));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (n == 0) return true;
+        len += static_cast<std::size_t>(n);
+        if (len == buffer.size()) buffer.resize(buffer.size() * 2);
+    }
+}
+
+ProcFile::ProcFile(std::string path)
+    : m_path(std::move(path)) {}
+
+ProcFile::~ProcFile() {
+    close();
+}
+
+ProcFile::ProcFile(ProcFile&& other) noexcept
+    : m_path(std::move(other.m_path))
+    , m_fd(std::exchange(other.m_fd, -1))
+    , m_buffer(std::move(other.m_buffer)) {}
+
+ProcFile& ProcFile::operator=(ProcFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_path = std::move(other.m_path);
+        m_fd = std::exchange(other.m_fd, -1);
+        m_buffer = std::move(other.m_buffer);
+    }
+    return *this;
+}
+
+void ProcFile::setPath(std::string path) {
+    if (m_path == path) return;
+    close();
+    m_path = std::move(path);
+}
+
+void ProcFile::close() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+std::string_view ProcFile::read() {
+    if (m_path.empty()) return {};
+
+    std::size_t len = 0;
+    if (!readAll(len)) {
+        // Stale descriptor, try once more with a fresh one
+        close();
+        if (!readAll(len)) {
+            close();
+            return {};
+        }
+    }
+    return { m_buffer.data(), len };
+}
+
+bool ProcFile::readInt(qint64& out) {
+    return parseInt(read(), out);
+}
+
+bool ProcFile::readDouble(double& out) {
+    return parseDouble(read(), out);
+}
+
+bool ProcFile::readAll(std::size_t& len) {
+    if (m_fd < 0) {
+        m_fd = ::open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (m_fd < 0) return false;
+    }
+
+    return readToEnd(m_fd, m_buffer, len);
+}
+
+std::string_view readFileAt(int dirFd, const char* name, std::vector<char>& buffer) {
+    const int fd = ::openat(dirFd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return {};
+
+    std::size_t len = 0;
+    const bool ok = readToEnd(fd, buffer, len);
+    ::close(fd);
+    return ok ? std::string_view(buffer.data(), len) : std::string_view();
+}
+
+qint64 monotonicNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<qint64>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+bool nextLine(std::string_view& text, std::string_view& line) {
+    if (text.empty()) return false;
+    const auto pos = text.find('\n');
+    if (pos == std::string_view::npos) {
+        line = text;
+        text = {};
+    } else {
+        line = text.substr(0, pos);
+        text.remove_prefix(pos + 1);
+    }
+    return true;
+}
+
+std::string_view nextField(std::string_view& line) {
+    std::size_t start = 0;
+    while (start < line.size() && isSpace(line[start])) ++start;
+    std::size_t end = start;
+    while (end < line.size() && !isSpace(line[end])) ++end;
+    const std::string_view field = line.substr(start, end - start);
+    line.remove_prefix(end);
+    return field;
+}
+
+bool nextInt(std::string_view& line, qint64& out) {
+    return parseInt(nextField(line), out);
+}
+
+qint64 nextInt(std::string_view& line) {
+    qint64 value = 0;
+    nextInt(line, value);
+    return value;
+}
+
+bool parseInt(std::string_view text, qint64& out) {
+    text = trimmed(text);
+    if (text.empty()) return false;
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc();
+}
+
+bool parseDouble(std::string_view text, double& out) {
+    text = trimmed(text);
+    if (text.empty()) return false;
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc();
+}
+
+std::string_view trimmed(std::string_view text) {
+    while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+    while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+} // namespace caelestia::procfs
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <qglobal.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace caelestia::procfs {
+
+/// Reads a /proc or sysfs file into a buffer that is reused across reads, so
+/// re-reading the same file every tick does not allocate once the buffer has
+/// grown to fit it. The descriptor is opened once and re-read from offset 0,
+/// which makes the kernel regenerate the contents; it is only reopened if a
+/// read fails (e.g. the device behind a sysfs file went away).
+class ProcFile {
+public:
+    ProcFile() = default;
+    explicit ProcFile(std::string path);
+    ~ProcFile();
+
+    ProcFile(ProcFile&& other) noexcept;
+    ProcFile& operator=(ProcFile&& other) noexcept;
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+
+    [[nodiscard]] bool isValid() const { return !m_path.empty(); }
+    [[nodiscard]] const std::string& path() const { return m_path; }
+    void setPath(std::string path);
+
+    /// Returns the whole file, or an empty view if it couldn't be read. The view
+    /// stays valid until the next call.
+    std::string_view read();
+
+    /// Reads a file holding a single number, as most sysfs attributes do.
+    bool readInt(qint64& out);
+    bool readDouble(double& out);
+
+private:
+    bool readAll(std::size_t& len);
+    void close();
+
+    std::string m_path;
+    int m_fd = -1;
+    std::vector<char> m_buffer;
+};
+
+/// One-shot read of `name` relative to the directory `dirFd` into `buffer`,
+/// which is grown as needed and reused by the caller across calls. For files
+/// that come and go (per-process entries) where holding descriptors open is
+/// not worth it. Returns an empty view if the file couldn't be read.
+std::string_view readFileAt(int dirFd, const char* name, std::vector<char>& buffer);
+
+/// CLOCK_MONOTONIC in nanoseconds, for turning counter deltas into rates.
+qint64 monotonicNs();
+
+/// Splits off the next line of `text`, without the newline.
+bool nextLine(std::string_view& text, std::string_view& line);
+
+/// Splits off the next whitespace-delimited field of `line`; empty at the end.
+std::string_view nextField(std::string_view& line);
+
+/// Parses the next field of `line` as an integer. On failure `out` is left untouched.
+bool nextInt(std::string_view& line, qint64& out);
+qint64 nextInt(std::string_view& line);
+
+bool parseInt(std::string_view text, qint64& out);
+bool parseDouble(std::string_view text, double& out);
+
+std::string_view trimmed(std::string_view text);
+
+} // namespace caelestia::procfs
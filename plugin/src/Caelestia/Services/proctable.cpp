@@ -0,0 +1,247 @@
+#include "proctable.hpp"
+
+#include "procfs.hpp"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utility>
+
+namespace caelestia {
+
+namespace {
+
+constexpr quint32 kDrmFdRescanPeriod = 5; // refreshes
+
+} // namespace
+
+ProcessTable::ProcessTable()
+    : m_procDir(opendir("/proc"))
+    , m_pageSizeKB(sysconf(_SC_PAGESIZE) / 1024) {}
+
+ProcessTable::~ProcessTable() {
+    if (m_procDir) closedir(m_procDir);
+}
+
+bool ProcessTable::refresh() {
+    if (!m_procDir) {
+        m_procDir = opendir("/proc");
+        if (!m_procDir) return false;
+    } else {
+        rewinddir(m_procDir);
+    }
+
+    // Measure the window rather than trusting the timer interval: ticks can be
+    // late, skipped while a sample is pending, or forced by updateAll()
+    const qint64 now = procfs::monotonicNs();
+    m_elapsed = m_lastRefreshNs > 0 ? static_cast<double>(now - m_lastRefreshNs) / 1e9 : 0.0;
+    m_lastRefreshNs = now;
+
+    const int procFd = dirfd(m_procDir);
+    ++m_generation;
+    const bool gpuRestarted = std::exchange(m_gpuRestarted, false);
+
+    while (const dirent* ent = readdir(m_procDir)) {
+        qint64 pid = 0;
+        if (ent->d_name[0] < '0' || ent->d_name[0] > '9' || !procfs::parseInt(ent->d_name, pid)) continue;
+
+        m_path.assign(ent->d_name).append("/stat");
+        StatFields stat;
+        if (!parseStat(procfs::readFileAt(procFd, m_path.c_str(), m_buffer), stat)) continue; // Exited meanwhile
+
+        auto it = m_processes.find(static_cast<int>(pid));
+        const bool known = it != m_processes.end();
+        if (!known) {
+            it = m_processes.insert(static_cast<int>(pid), ProcessEntry{});
+            it->pid = static_cast<int>(pid);
+        }
+
+        bool exec = false;
+        applyStat(*it, stat, known, exec);
+        if (exec) {
+            m_path.assign(ent->d_name).append("/cmdline");
+            readCmdline(*it, procfs::readFileAt(procFd, m_path.c_str(), m_buffer));
+        }
+        if (m_trackGpu) {
+            // Spread fd rescans over refreshes instead of walking every fd table at once
+            if (exec || it->drmFdsStale || (static_cast<quint32>(pid) + m_generation) % kDrmFdRescanPeriod == 0) {
+                scanDrmFds(*it, procFd, ent->d_name);
+            }
+            readGpuTime(*it, procFd, ent->d_name, known && !exec && !gpuRestarted);
+        }
+        it->generation = m_generation;
+    }
+
+    // Anything not seen this pass has exited
+    m_processes.removeIf([this](const QHash<int, ProcessEntry>::iterator it) {
+        return it->generation != m_generation;
+    });
+    return true;
+}
+
+void ProcessTable::setTrackGpu(bool track) {
+    if (m_trackGpu == track) return;
+    m_trackGpu = track;
+
+    // Fd lists go stale while off, and a delta across the pause would be the
+    // average over it, so start over
+    for (ProcessEntry& entry : m_processes) {
+        entry.drmFds.clear();
+        entry.drmFdsStale = true;
+        entry.gpuTimeDelta = 0;
+    }
+    m_gpuRestarted = track;
+}
+
+bool ProcessTable::readThreads(int pid, std::vector<ThreadEntry>& out) {
+    out.clear();
+
+    const std::string taskPath = "/proc/" + std::to_string(pid) + "/task";
+    DIR* taskDir = opendir(taskPath.c_str());
+    if (!taskDir) return false;
+
+    const int taskFd = dirfd(taskDir);
+    while (const dirent* ent = readdir(taskDir)) {
+        qint64 tid = 0;
+        if (ent->d_name[0] < '0' || ent->d_name[0] > '9' || !procfs::parseInt(ent->d_name, tid)) continue;
+
+        m_path.assign(ent->d_name).append("/stat");
+        StatFields stat;
+        if (!parseStat(procfs::readFileAt(taskFd, m_path.c_str(), m_buffer), stat)) continue;
+
+        out.push_back({ static_cast<int>(tid), stat.startTime, stat.cpuTicks,
+            QString::fromUtf8(stat.comm.data(), static_cast<qsizetype>(stat.comm.size())) });
+    }
+
+    closedir(taskDir);
+    return true;
+}
+
+bool ProcessTable::parseStat(std::string_view stat, StatFields& out) {
+    // "pid (comm) state ppid ..." - comm may itself contain spaces and parens,
+    // so it runs to the last ')'
+    const auto open = stat.find('(');
+    const auto close = stat.rfind(')');
+    if (open == std::string_view::npos || close == std::string_view::npos || close < open) return false;
+
+    std::string_view fields = stat.substr(close + 1);
+
+    // Fields after comm, 0-based: state(0) ppid(1) ... utime(11) stime(12) ... starttime(19) vsize(20) rss(21)
+    qint64 values[22] = {};
+    for (int i = 0; i < 22; ++i) {
+        if (i == 0) {
+            procfs::nextField(fields);
+        } else if (!procfs::nextInt(fields, values[i])) {
+            return false;
+        }
+    }
+
+    out.comm = stat.substr(open + 1, close - open - 1);
+    out.ppid = static_cast<int>(values[1]);
+    out.cpuTicks = values[11] + values[12];
+    out.startTime = values[19];
+    out.rssPages = values[21];
+    return true;
+}
+
+void ProcessTable::applyStat(ProcessEntry& entry, const StatFields& stat, bool known, bool& exec) const {
+    if (known && entry.startTime != stat.startTime) {
+        // Same pid, different process: start over
+        const int pid = entry.pid;
+        entry = ProcessEntry{};
+        entry.pid = pid;
+        known = false;
+    }
+
+    entry.ppid = stat.ppid;
+    entry.startTime = stat.startTime;
+    entry.cpuTicksDelta = known ? qMax(stat.cpuTicks - entry.cpuTicks, qint64(0)) : 0;
+    entry.cpuTicks = stat.cpuTicks;
+    entry.rssKB = stat.rssPages * m_pageSizeKB;
+
+    exec = !known || entry.rawComm != stat.comm;
+    if (exec) {
+        entry.rawComm.assign(stat.comm);
+        entry.command = QString::fromUtf8(stat.comm.data(), static_cast<qsizetype>(stat.comm.size()));
+    }
+}
+
+void ProcessTable::scanDrmFds(ProcessEntry& entry, int procFd, const char* pidName) {
+    entry.drmFds.clear();
+    entry.drmFdsStale = false;
+
+    m_path.assign(pidName).append("/fd");
+    const int fd = openat(procFd, m_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return; // Other users' processes aren't readable
+    DIR* dir = fdopendir(fd);
+    if (!dir) {
+        ::close(fd);
+        return;
+    }
+
+    char target[64];
+    while (const dirent* ent = readdir(dir)) {
+        if (ent->d_name[0] < '0' || ent->d_name[0] > '9') continue;
+        const ssize_t len = readlinkat(dirfd(dir), ent->d_name, target, sizeof(target));
+        if (len <= 0 || !std::string_view(target, static_cast<std::size_t>(len)).starts_with("/dev/dri/")) continue;
+
+        qint64 num = 0;
+        if (procfs::parseInt(ent->d_name, num)) entry.drmFds.push_back(static_cast<int>(num));
+    }
+    closedir(dir);
+}
+
+void ProcessTable::readGpuTime(ProcessEntry& entry, int procFd, const char* pidName, bool known) {
+    // Several fds can share one DRM client (dup, fork), so count each
+    // drm-client-id once
+    qint64 total = 0;
+    m_seenClients.clear();
+    for (const int fd : entry.drmFds) {
+        m_path.assign(pidName).append("/fdinfo/").append(std::to_string(fd));
+        std::string_view text = procfs::readFileAt(procFd, m_path.c_str(), m_buffer);
+        if (text.empty()) {
+            entry.drmFdsStale = true; // Closed since the last scan
+            continue;
+        }
+
+        qint64 client = -1;
+        qint64 engineNs = 0;
+        std::string_view line;
+        while (procfs::nextLine(text, line)) {
+            const auto colon = line.find(':');
+            if (colon == std::string_view::npos) continue;
+            const std::string_view key = line.substr(0, colon);
+            std::string_view value = line.substr(colon + 1);
+
+            if (key == "drm-client-id") {
+                procfs::parseInt(value, client);
+            } else if (key.starts_with("drm-engine-") && !key.starts_with("drm-engine-capacity-")) {
+                // "drm-engine-gfx:\t123456 ns"
+                qint64 ns = 0;
+                if (procfs::nextInt(value, ns)) engineNs += ns;
+            }
+        }
+
+        if (client < 0 || std::ranges::find(m_seenClients, client) != m_seenClients.end()) continue;
+        m_seenClients.push_back(client);
+        total += engineNs;
+    }
+
+    entry.gpuTimeDelta = known ? qMax(total - entry.gpuTime, qint64(0)) : 0;
+    entry.gpuTime = total;
+}
+
+void ProcessTable::readCmdline(ProcessEntry& entry, std::string_view cmdline) {
+    // NUL-separated argv; kernel threads and zombies have none
+    while (!cmdline.empty() && (cmdline.back() == '\0' || cmdline.back() == ' ')) cmdline.remove_suffix(1);
+    if (cmdline.empty()) {
+        entry.fullCommand = entry.command;
+        return;
+    }
+
+    QString full = QString::fromUtf8(cmdline.data(), static_cast<qsizetype>(cmdline.size()));
+    full.replace(QChar(u'\0'), QChar(u' '));
+    entry.fullCommand = full.trimmed();
+}
+
+} // namespace caelestia
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <qhash.h>
+#include <qstring.h>
+
+#include <dirent.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace caelestia {
+
+/// A live process as last seen in /proc. Identity is (pid, startTime): a pid
+/// reused by a new process gets a fresh entry rather than inheriting the old
+/// one's cached command line or CPU counters.
+struct ProcessEntry {
+    int pid = 0;
+    int ppid = 0;
+    qint64 startTime = 0; // clock ticks after boot
+    qint64 cpuTicks = 0; // utime + stime
+    qint64 cpuTicksDelta = 0; // since the previous refresh, 0 on the first sighting
+    qint64 rssKB = 0;
+    QString command; // comm, at most 15 bytes
+    QString fullCommand; // cmdline, or comm for kernel threads
+    qint64 gpuTime = 0; // DRM engine ns summed over the process's clients, if GPU tracking is on
+    qint64 gpuTimeDelta = 0;
+
+    std::vector<int> drmFds; // Open /dev/dri fds, rescanned now and then
+    bool drmFdsStale = true;
+    std::string rawComm; // To notice an exec without converting comm every tick
+    quint32 generation = 0; // Last refresh that saw this process
+};
+
+/// A thread of one process, from /proc/<pid>/task/<tid>/stat.
+struct ThreadEntry {
+    int tid = 0;
+    qint64 startTime = 0;
+    qint64 cpuTicks = 0;
+    QString name;
+};
+
+/// Persistent pid-keyed view of /proc. Each refresh re-reads only
+/// /proc/<pid>/stat for the pids currently listed; cmdline is read once per
+/// process and again only when its comm changes (i.e. it exec'd). Entries and
+/// read buffers are reused across refreshes, and exited processes are
+/// dropped by generation rather than by rebuilding the table.
+class ProcessTable {
+public:
+    ProcessTable();
+    ~ProcessTable();
+
+    ProcessTable(const ProcessTable&) = delete;
+    ProcessTable& operator=(const ProcessTable&) = delete;
+
+    /// Rescans /proc. Returns false (leaving the table as it was) if /proc
+    /// couldn't be listed.
+    bool refresh();
+
+    [[nodiscard]] const QHash<int, ProcessEntry>& processes() const { return m_processes; }
+    [[nodiscard]] qsizetype size() const { return m_processes.size(); }
+
+    /// Monotonic seconds between the last two refreshes, i.e. the window the
+    /// cpuTicksDelta values cover. 0 until the second refresh.
+    [[nodiscard]] double elapsed() const { return m_elapsed; }
+    /// Forgets when the last refresh was, so the next one reports a window of
+    /// 0 rather than one spanning a pause in refreshing.
+    void restartWindow() { m_lastRefreshNs = 0; }
+
+    /// Also collects per-process GPU engine time from the DRM fdinfo of each
+    /// process's /dev/dri descriptors. Which fds those are is cached and only
+    /// rescanned every few refreshes, staggered across processes. This walks
+    /// fd tables, so it should only be on while someone looks at the result.
+    void setTrackGpu(bool track);
+
+    /// Lists the threads of `pid` into `out`. Returns false if the process is gone.
+    bool readThreads(int pid, std::vector<ThreadEntry>& out);
+
+private:
+    struct StatFields {
+        std::string_view comm;
+        int ppid = 0;
+        qint64 cpuTicks = 0;
+        qint64 startTime = 0;
+        qint64 rssPages = 0;
+    };
+    static bool parseStat(std::string_view stat, StatFields& out);
+
+    void applyStat(ProcessEntry& entry, const StatFields& stat, bool known, bool& exec) const;
+    static void readCmdline(ProcessEntry& entry, std::string_view cmdline);
+    void scanDrmFds(ProcessEntry& entry, int procFd, const char* pidName);
+    void readGpuTime(ProcessEntry& entry, int procFd, const char* pidName, bool known);
+
+    QHash<int, ProcessEntry> m_processes;
+    quint32 m_generation = 0;
+    qint64 m_lastRefreshNs = 0;
+    double m_elapsed = 0;
+    bool m_trackGpu = false;
+    bool m_gpuRestarted = false; // Engine times are from before tracking was last off
+    std::vector<qint64> m_seenClients;
+
+    DIR* m_procDir = nullptr;
+    qint64 m_pageSizeKB;
+    std::vector<char> m_buffer;
+    std::string m_path;
+};
+
+} // namespace caelestia
@@ -0,0 +1,466 @@
+#include "sysmodels.hpp"
+
+#include <algorithm>
+
+namespace caelestia {
+
+CpuCoreModel::CpuCoreModel(QObject* parent)
+    : QAbstractListModel(parent) {}
+
+int CpuCoreModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) return 0;
+    return static_cast<int>(m_cores.size());
+}
+
+QVariant CpuCoreModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_cores.size()) return {};
+
+    const Core& core = m_cores.at(index.row());
+    switch (role) {
+    case UsageRole:
+        return core.load.usage;
+    case IowaitRole:
+        return core.load.iowait;
+    case StealRole:
+        return core.load.steal;
+    case FrequencyRole:
+        return core.frequency;
+    case HistoryRole:
+        return QVariant::fromValue(core.history.toList());
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> CpuCoreModel::roleNames() const {
+    return {
+        { UsageRole, "usage" },
+        { IowaitRole, "iowait" },
+        { StealRole, "steal" },
+        { FrequencyRole, "frequency" },
+        { HistoryRole, "history" },
+    };
+}
+
+void CpuCoreModel::setHistoryLength(qsizetype length) {
+    if (m_historyLength == length) return;
+    m_historyLength = length;
+    for (Core& core : m_cores) {
+        core.history.setCapacity(length);
+    }
+    if (!m_cores.isEmpty()) emit dataChanged(index(0), index(rowCount() - 1), { HistoryRole });
+}
+
+void CpuCoreModel::update(const QList<CpuLoad>& loads, const QList<qreal>& frequencies) {
+    if (loads.size() != m_cores.size()) {
+        beginResetModel();
+        m_cores.clear();
+        m_cores.resize(loads.size());
+        for (Core& core : m_cores) {
+            core.history.setCapacity(m_historyLength);
+        }
+        endResetModel();
+    }
+    if (m_cores.isEmpty()) return;
+
+    for (qsizetype i = 0; i < m_cores.size(); ++i) {
+        Core& core = m_cores[i];
+        core.load = loads.at(i);
+        core.frequency = frequencies.value(i);
+        core.history.push(core.load.usage);
+    }
+
+    // Every core gets a new history sample each tick, so one ranged
+    // notification is cheaper than diffing rows
+    emit dataChanged(index(0), index(rowCount() - 1));
+}
+
+ProcessListModel::ProcessListModel(QObject* parent)
+    : QAbstractListModel(parent) {}
+
+int ProcessListModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) return 0;
+    return static_cast<int>(m_rows.size());
+}
+
+QVariant ProcessListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_rows.size()) return {};
+
+    const ProcessRow& row = m_rows.at(index.row());
+    switch (role) {
+    case PidRole:
+        return row.pid;
+    case PpidRole:
+        return row.ppid;
+    case CpuRole:
+        return row.cpu;
+    case MemoryPercentRole:
+        return row.memoryPercent;
+    case MemoryKBRole:
+        return row.memoryKB;
+    case GpuRole:
+        return row.gpu;
+    case TreeCpuRole:
+        return row.treeCpu;
+    case TreeMemoryKBRole:
+        return row.treeMemoryKB;
+    case CommandRole:
+        return row.command;
+    case FullCommandRole:
+        return row.fullCommand;
+    case DisplayNameRole:
+        return row.command.length() > 15 ? row.command.left(15) + "..." : row.command;
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> ProcessListModel::roleNames() const {
+    return {
+        { PidRole, "pid" },
+        { PpidRole, "ppid" },
+        { CpuRole, "cpu" },
+        { MemoryPercentRole, "memoryPercent" },
+        { MemoryKBRole, "memoryKB" },
+        { GpuRole, "gpu" },
+        { TreeCpuRole, "treeCpu" },
+        { TreeMemoryKBRole, "treeMemoryKB" },
+        { CommandRole, "command" },
+        { FullCommandRole, "fullCommand" },
+        { DisplayNameRole, "displayName" },
+    };
+}
+
+void ProcessListModel::update(const QList<ProcessRow>& rows) {
+    const auto sameProcess = [](const ProcessRow& a, const ProcessRow& b) {
+        return a.pid == b.pid && a.startTime == b.startTime;
+    };
+
+    // Drop processes that fell out of the list
+    for (auto i = m_rows.size() - 1; i >= 0; --i) {
+        const ProcessRow& row = m_rows.at(i);
+        if (std::ranges::none_of(rows, [&](const ProcessRow& r) { return sameProcess(r, row); })) {
+            beginRemoveRows(QModelIndex(), static_cast<int>(i), static_cast<int>(i));
+            m_rows.removeAt(i);
+            endRemoveRows();
+        }
+    }
+
+    // Walk the new order, pulling each process up from wherever it is now or
+    // inserting it. Everything before `i` is final, so rows only move upwards.
+    // The list is capped at maxProcesses, so the linear lookups stay cheap.
+    for (qsizetype i = 0; i < rows.size(); ++i) {
+        const ProcessRow& row = rows.at(i);
+        qsizetype from = i;
+        while (from < m_rows.size() && !sameProcess(m_rows.at(from), row)) ++from;
+
+        if (from == m_rows.size()) {
+            beginInsertRows(QModelIndex(), static_cast<int>(i), static_cast<int>(i));
+            m_rows.insert(i, row);
+            endInsertRows();
+            continue;
+        }
+
+        if (from != i) {
+            const auto src = static_cast<int>(from);
+            beginMoveRows(QModelIndex(), src, src, QModelIndex(), static_cast<int>(i));
+            m_rows.move(from, i);
+            endMoveRows();
+        }
+
+        ProcessRow& current = m_rows[i];
+        QList<int> roles;
+        if (current.ppid != row.ppid) roles << PpidRole;
+        if (current.cpu != row.cpu) roles << CpuRole;
+        if (current.memoryPercent != row.memoryPercent) roles << MemoryPercentRole;
+        if (current.memoryKB != row.memoryKB) roles << MemoryKBRole;
+        if (current.gpu != row.gpu) roles << GpuRole;
+        if (current.treeCpu != row.treeCpu) roles << TreeCpuRole;
+        if (current.treeMemoryKB != row.treeMemoryKB) roles << TreeMemoryKBRole;
+        if (current.command != row.command) roles << CommandRole << DisplayNameRole;
+        if (current.fullCommand != row.fullCommand) roles << FullCommandRole;
+        if (!roles.isEmpty()) {
+            current = row;
+            emit dataChanged(index(static_cast<int>(i)), index(static_cast<int>(i)), roles);
+        }
+    }
+}
+
+NetworkInterfaceModel::NetworkInterfaceModel(QObject* parent)
+    : QAbstractListModel(parent) {}
+
+int NetworkInterfaceModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) return 0;
+    return static_cast<int>(m_interfaces.size());
+}
+
+QVariant NetworkInterfaceModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_interfaces.size()) return {};
+
+    const Interface& iface = m_interfaces.at(index.row());
+    switch (role) {
+    case NameRole:
+        return iface.stats.name;
+    case KindRole:
+        return iface.stats.kind;
+    case RxRateRole:
+        return iface.stats.rxRate;
+    case TxRateRole:
+        return iface.stats.txRate;
+    case RxBytesRole:
+        return iface.stats.rxBytes;
+    case TxBytesRole:
+        return iface.stats.txBytes;
+    case RxHistoryRole:
+        return QVariant::fromValue(iface.rxHistory.toList());
+    case TxHistoryRole:
+        return QVariant::fromValue(iface.txHistory.toList());
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> NetworkInterfaceModel::roleNames() const {
+    return {
+        { NameRole, "name" },
+        { KindRole, "kind" },
+        { RxRateRole, "rxRate" },
+        { TxRateRole, "txRate" },
+        { RxBytesRole, "rxBytes" },
+        { TxBytesRole, "txBytes" },
+        { RxHistoryRole, "rxHistory" },
+        { TxHistoryRole, "txHistory" },
+    };
+}
+
+void NetworkInterfaceModel::setHistoryLength(qsizetype length) {
+    if (m_historyLength == length) return;
+    m_historyLength = length;
+    for (Interface& iface : m_interfaces) {
+        iface.rxHistory.setCapacity(length);
+        iface.txHistory.setCapacity(length);
+    }
+    if (!m_interfaces.isEmpty()) {
+        emit dataChanged(index(0), index(rowCount() - 1), { RxHistoryRole, TxHistoryRole });
+    }
+}
+
+void NetworkInterfaceModel::update(const QList<NetInterfaceStats>& interfaces) {
+    for (auto i = m_interfaces.size() - 1; i >= 0; --i) {
+        const QString& name = m_interfaces.at(i).stats.name;
+        if (std::ranges::none_of(interfaces, [&](const NetInterfaceStats& s) { return s.name == name; })) {
+            beginRemoveRows(QModelIndex(), static_cast<int>(i), static_cast<int>(i));
+            m_interfaces.removeAt(i);
+            endRemoveRows();
+        }
+    }
+
+    // Same ordering walk as ProcessListModel::update(), but interfaces rarely
+    // change, so this is almost always a straight pass over matching rows
+    for (qsizetype i = 0; i < interfaces.size(); ++i) {
+        const NetInterfaceStats& stats = interfaces.at(i);
+        qsizetype from = i;
+        while (from < m_interfaces.size() && m_interfaces.at(from).stats.name != stats.name) ++from;
+
+        if (from == m_interfaces.size()) {
+            Interface iface;
+            iface.rxHistory.setCapacity(m_historyLength);
+            iface.txHistory.setCapacity(m_historyLength);
+            beginInsertRows(QModelIndex(), static_cast<int>(i), static_cast<int>(i));
+            m_interfaces.insert(i, iface);
+            endInsertRows();
+        } else if (from != i) {
+            const auto src = static_cast<int>(from);
+            beginMoveRows(QModelIndex(), src, src, QModelIndex(), static_cast<int>(i));
+            m_interfaces.move(from, i);
+            endMoveRows();
+        }
+
+        Interface& iface = m_interfaces[i];
+        iface.stats = stats;
+        iface.rxHistory.push(stats.rxRate);
+        iface.txHistory.push(stats.txRate);
+    }
+
+    // Every interface gets a new history sample each tick
+    if (!m_interfaces.isEmpty()) emit dataChanged(index(0), index(rowCount() - 1));
+}
+
+DiskDeviceModel::DiskDeviceModel(QObject* parent)
+    : QAbstractListModel(parent) {}
+
+int DiskDeviceModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) return 0;
+    return static_cast<int>(m_devices.size());
+}
+
+QVariant DiskDeviceModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_devices.size()) return {};
+
+    const Device& device = m_devices.at(index.row());
+    switch (role) {
+    case NameRole:
+        return device.stats.name;
+    case LabelRole:
+        return device.stats.label;
+    case KindRole:
+        return device.stats.kind;
+    case ReadRateRole:
+        return device.stats.readRate;
+    case WriteRateRole:
+        return device.stats.writeRate;
+    case ReadIopsRole:
+        return device.stats.readIops;
+    case WriteIopsRole:
+        return device.stats.writeIops;
+    case UtilizationRole:
+        return device.stats.utilization;
+    case LatencyRole:
+        return device.stats.latency;
+    case ReadHistoryRole:
+        return QVariant::fromValue(device.readHistory.toList());
+    case WriteHistoryRole:
+        return QVariant::fromValue(device.writeHistory.toList());
+    case UtilizationHistoryRole:
+        return QVariant::fromValue(device.utilizationHistory.toList());
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> DiskDeviceModel::roleNames() const {
+    return {
+        { NameRole, "name" },
+        { LabelRole, "label" },
+        { KindRole, "kind" },
+        { ReadRateRole, "readRate" },
+        { WriteRateRole, "writeRate" },
+        { ReadIopsRole, "readIops" },
+        { WriteIopsRole, "writeIops" },
+        { UtilizationRole, "utilization" },
+        { LatencyRole, "latency" },
+        { ReadHistoryRole, "readHistory" },
+        { WriteHistoryRole, "writeHistory" },
+        { UtilizationHistoryRole, "utilizationHistory" },
+    };
+}
+
+void DiskDeviceModel::setHistoryLength(qsizetype length) {
+    if (m_historyLength == length) return;
+    m_historyLength = length;
+    for (Device& device : m_devices) {
+        device.readHistory.setCapacity(length);
+        device.writeHistory.setCapacity(length);
+        device.utilizationHistory.setCapacity(length);
+    }
+    if (!m_devices.isEmpty()) {
+        const QList<int> roles{ ReadHistoryRole, WriteHistoryRole, UtilizationHistoryRole };
+        emit dataChanged(index(0), index(rowCount() - 1), roles);
+    }
+}
+
+void DiskDeviceModel::update(const QList<DiskStats>& devices) {
+    for (auto i = m_devices.size() - 1; i >= 0; --i) {
+        const QString& name = m_devices.at(i).stats.name;
+        if (std::ranges::none_of(devices, [&](const DiskStats& s) { return s.name == name; })) {
+            beginRemoveRows(QModelIndex(), static_cast<int>(i), static_cast<int>(i));
+            m_devices.removeAt(i);
+            endRemoveRows();
+        }
+    }
+
+    // Same ordering walk as NetworkInterfaceModel::update()
+    for (qsizetype i = 0; i < devices.size(); ++i) {
+        const DiskStats& stats = devices.at(i);
+        qsizetype from = i;
+        while (from < m_devices.size() && m_devices.at(from).stats.name != stats.name) ++from;
+
+        if (from == m_devices.size()) {
+            Device device;
+            device.readHistory.setCapacity(m_historyLength);
+            device.writeHistory.setCapacity(m_historyLength);
+            device.utilizationHistory.setCapacity(m_historyLength);
+            beginInsertRows(QModelIndex(), static_cast<int>(i), static_cast<int>(i));
+            m_devices.insert(i, device);
+            endInsertRows();
+        } else if (from != i) {
+            const auto src = static_cast<int>(from);
+            beginMoveRows(QModelIndex(), src, src, QModelIndex(), static_cast<int>(i));
+            m_devices.move(from, i);
+            endMoveRows();
+        }
+
+        Device& device = m_devices[i];
+        device.stats = stats;
+        device.readHistory.push(stats.readRate);
+        device.writeHistory.push(stats.writeRate);
+        device.utilizationHistory.push(stats.utilization);
+    }
+
+    if (!m_devices.isEmpty()) emit dataChanged(index(0), index(rowCount() - 1));
+}
+
+MountListModel::MountListModel(QObject* parent)
+    : QAbstractListModel(parent) {}
+
+int MountListModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) return 0;
+    return static_cast<int>(m_rows.size());
+}
+
+QVariant MountListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_rows.size()) return {};
+
+    const MountStats& row = m_rows.at(index.row());
+    switch (role) {
+    case DeviceRole:
+        return row.device;
+    case MountRole:
+        return row.mount;
+    case FstypeRole:
+        return row.fstype;
+    case SizeRole:
+        return row.size;
+    case UsedRole:
+        return row.used;
+    case AvailRole:
+        return row.avail;
+    case PercentRole:
+        return row.percent;
+    case ResponsiveRole:
+        return row.responsive;
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> MountListModel::roleNames() const {
+    return {
+        { DeviceRole, "device" },
+        { MountRole, "mount" },
+        { FstypeRole, "fstype" },
+        { SizeRole, "size" },
+        { UsedRole, "used" },
+        { AvailRole, "avail" },
+        { PercentRole, "percent" },
+        { ResponsiveRole, "responsive" },
+    };
+}
+
+void MountListModel::update(const QList<MountStats>& rows) {
+    const bool sameMounts = std::ranges::equal(rows, m_rows, {}, &MountStats::mount, &MountStats::mount);
+    if (!sameMounts) {
+        beginResetModel();
+        m_rows = rows;
+        endResetModel();
+        return;
+    }
+
+    for (qsizetype i = 0; i < rows.size(); ++i) {
+        if (m_rows.at(i) == rows.at(i)) continue;
+        m_rows[i] = rows.at(i);
+        emit dataChanged(index(static_cast<int>(i)), index(static_cast<int>(i)));
+    }
+}
+
+} // namespace caelestia
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "syssampler.hpp"
+
+#include <qabstractitemmodel.h>
+#include <qlist.h>
+
+namespace caelestia {
+
+/// Fixed-capacity history of samples. Once full, each push overwrites the
+/// oldest sample in place, so steady-state recording never allocates.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(qsizetype capacity = 0) { setCapacity(capacity); }
+
+    qsizetype capacity() const { return m_capacity; }
+    qsizetype size() const { return m_data.size(); }
+    bool isEmpty() const { return m_data.isEmpty(); }
+
+    /// Changing the capacity drops the recorded samples.
+    void setCapacity(qsizetype capacity) {
+        m_capacity = qMax(capacity, qsizetype(0));
+        clear();
+    }
+
+    void clear() {
+        m_data.clear();
+        m_data.reserve(m_capacity);
+        m_head = 0;
+    }
+
+    void push(const T& value) {
+        if (m_capacity == 0) return;
+        if (m_data.size() < m_capacity) {
+            m_data.append(value);
+        } else {
+            m_data[m_head] = value;
+            m_head = (m_head + 1) % m_capacity;
+        }
+    }
+
+    /// Most recent sample; the buffer must not be empty.
+    const T& last() const { return m_data.at((m_head + m_data.size() - 1) % m_data.size()); }
+
+    /// Samples ordered oldest to newest.
+    QList<T> toList() const {
+        if (m_head == 0) return m_data;
+        QList<T> out;
+        out.reserve(m_data.size());
+        out.append(m_data.sliced(m_head));
+        out.append(m_data.first(m_head));
+        return out;
+    }
+
+private:
+    QList<T> m_data;
+    qsizetype m_capacity = 0;
+    qsizetype m_head = 0; // Oldest sample once the buffer has wrapped
+};
+
+/// One row per logical CPU with its current load, frequency and a history of
+/// usage for sparklines. Rows only reset when the core count changes.
+class CpuCoreModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        UsageRole = Qt::UserRole + 1,
+        IowaitRole,
+        StealRole,
+        FrequencyRole,
+        HistoryRole,
+    };
+    Q_ENUM(Role)
+
+    explicit CpuCoreModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setHistoryLength(qsizetype length);
+    void update(const QList<CpuLoad>& loads, const QList<qreal>& frequencies);
+
+private:
+    struct Core {
+        CpuLoad load;
+        qreal frequency = 0;
+        RingBuffer<qreal> history;
+    };
+
+    QList<Core> m_cores;
+    qsizetype m_historyLength = 0;
+};
+
+/// The published process list. Rows are matched by process identity between
+/// updates, so re-ranking shows up as row moves and a changed value as a
+/// dataChanged on that row with just the affected roles; the model is never
+/// reset.
+class ProcessListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        PidRole = Qt::UserRole + 1,
+        PpidRole,
+        CpuRole,
+        MemoryPercentRole,
+        MemoryKBRole,
+        GpuRole,
+        TreeCpuRole,
+        TreeMemoryKBRole,
+        CommandRole,
+        FullCommandRole,
+        DisplayNameRole,
+    };
+    Q_ENUM(Role)
+
+    explicit ProcessListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    [[nodiscard]] const QList<ProcessRow>& rows() const { return m_rows; }
+    void update(const QList<ProcessRow>& rows);
+
+private:
+    QList<ProcessRow> m_rows;
+};
+
+/// One row per network interface with its current rates and a history of
+/// each for sparklines. Interfaces keep their row, and its history, while
+/// others come and go.
+class NetworkInterfaceModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        NameRole = Qt::UserRole + 1,
+        KindRole,
+        RxRateRole,
+        TxRateRole,
+        RxBytesRole,
+        TxBytesRole,
+        RxHistoryRole,
+        TxHistoryRole,
+    };
+    Q_ENUM(Role)
+
+    explicit NetworkInterfaceModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setHistoryLength(qsizetype length);
+    void update(const QList<NetInterfaceStats>& interfaces);
+
+private:
+    struct Interface {
+        NetInterfaceStats stats;
+        RingBuffer<qreal> rxHistory;
+        RingBuffer<qreal> txHistory;
+    };
+
+    QList<Interface> m_interfaces;
+    qsizetype m_historyLength = 0;
+};
+
+/// One row per whole block device with its current throughput, IOPS,
+/// utilization and latency, and histories of throughput and utilization.
+/// Devices keep their row while others are attached or removed.
+class DiskDeviceModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        NameRole = Qt::UserRole + 1,
+        LabelRole,
+        KindRole,
+        ReadRateRole,
+        WriteRateRole,
+        ReadIopsRole,
+        WriteIopsRole,
+        UtilizationRole,
+        LatencyRole,
+        ReadHistoryRole,
+        WriteHistoryRole,
+        UtilizationHistoryRole,
+    };
+    Q_ENUM(Role)
+
+    explicit DiskDeviceModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setHistoryLength(qsizetype length);
+    void update(const QList<DiskStats>& devices);
+
+private:
+    struct Device {
+        DiskStats stats;
+        RingBuffer<qreal> readHistory;
+        RingBuffer<qreal> writeHistory;
+        RingBuffer<qreal> utilizationHistory;
+    };
+
+    QList<Device> m_devices;
+    qsizetype m_historyLength = 0;
+};
+
+/// One row per mounted filesystem with its size and usage in bytes. Mount
+/// changes are rare, so a different set of mounts resets the model; usage
+/// updates only touch the rows that changed.
+class MountListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        DeviceRole = Qt::UserRole + 1,
+        MountRole,
+        FstypeRole,
+        SizeRole,
+        UsedRole,
+        AvailRole,
+        PercentRole,
+        ResponsiveRole,
+    };
+    Q_ENUM(Role)
+
+    explicit MountListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    [[nodiscard]] const QList<MountStats>& rows() const { return m_rows; }
+    void update(const QList<MountStats>& rows);
+
+private:
+    QList<MountStats> m_rows;
+};
+
+} // namespace caelestia
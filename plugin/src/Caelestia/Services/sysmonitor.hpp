@@ -1,14 +1,27 @@
 #pragma once
 
+#include "sysmodels.hpp"
+#include "syssampler.hpp"
+
+#include <QElapsedTimer>
 #include <QObject>
+#include <QThread>
 #include <QTimer>
 #include <QVariantList>
 #include <QVariantMap>
 #include <qqmlintegration.h>
-#include <QHash>
+
+#include <array>
 
 namespace caelestia {
 
+/// QML front end for system metrics. Sampling runs on a worker thread
+/// (SysSampler); the properties below mirror its latest snapshot.
+///
+/// Nothing is sampled unless asked for: views subscribe to the collectors
+/// they show through SysMonitorRef, each with the interval it wants, and
+/// every collector runs at the shortest interval requested for it. With no
+/// subscriptions the timer stops.
 class SysMonitor : public QObject {
     Q_OBJECT
     QML_ELEMENT
@@ -16,29 +29,107 @@ class SysMonitor : public QObject {
 
     Q_PROPERTY(QVariantMap memory READ memory NOTIFY memoryChanged)
     Q_PROPERTY(QVariantMap cpu READ cpu NOTIFY cpuChanged)
+    Q_PROPERTY(qreal cpuUsage READ cpuUsage NOTIFY cpuLoadChanged)
+    Q_PROPERTY(qreal cpuIowait READ cpuIowait NOTIFY cpuLoadChanged)
+    Q_PROPERTY(qreal cpuSteal READ cpuSteal NOTIFY cpuLoadChanged)
+    Q_PROPERTY(QList<qreal> cpuHistory READ cpuHistory NOTIFY cpuLoadChanged)
+    Q_PROPERTY(QList<qreal> coreUsage READ coreUsage NOTIFY cpuLoadChanged)
+    Q_PROPERTY(QList<qreal> coreFrequencies READ coreFrequencies NOTIFY cpuLoadChanged)
+    Q_PROPERTY(QAbstractListModel* cpuCores READ cpuCores CONSTANT)
     Q_PROPERTY(QVariantList network READ network NOTIFY networkChanged)
+    Q_PROPERTY(qreal netRxRate READ netRxRate NOTIFY netRatesChanged)
+    Q_PROPERTY(qreal netTxRate READ netTxRate NOTIFY netRatesChanged)
+    Q_PROPERTY(qint64 netRxBytes READ netRxBytes NOTIFY netRatesChanged)
+    Q_PROPERTY(qint64 netTxBytes READ netTxBytes NOTIFY netRatesChanged)
+    Q_PROPERTY(QList<qreal> netRxHistory READ netRxHistory NOTIFY netRatesChanged)
+    Q_PROPERTY(QList<qreal> netTxHistory READ netTxHistory NOTIFY netRatesChanged)
+    Q_PROPERTY(QAbstractListModel* netInterfaces READ netInterfaces CONSTANT)
     Q_PROPERTY(QVariantList disk READ disk NOTIFY diskChanged)
+    Q_PROPERTY(qreal diskReadRate READ diskReadRate NOTIFY diskRatesChanged)
+    Q_PROPERTY(qreal diskWriteRate READ diskWriteRate NOTIFY diskRatesChanged)
+    Q_PROPERTY(qreal diskIops READ diskIops NOTIFY diskRatesChanged)
+    Q_PROPERTY(qreal diskUtilization READ diskUtilization NOTIFY diskRatesChanged)
+    Q_PROPERTY(qreal diskLatency READ diskLatency NOTIFY diskRatesChanged)
+    Q_PROPERTY(QList<qreal> diskReadHistory READ diskReadHistory NOTIFY diskRatesChanged)
+    Q_PROPERTY(QList<qreal> diskWriteHistory READ diskWriteHistory NOTIFY diskRatesChanged)
+    Q_PROPERTY(QList<qreal> diskUtilizationHistory READ diskUtilizationHistory NOTIFY diskRatesChanged)
+    Q_PROPERTY(QAbstractListModel* diskDevices READ diskDevices CONSTANT)
     Q_PROPERTY(QVariantList processes READ processes NOTIFY processesChanged)
+    Q_PROPERTY(QAbstractListModel* processModel READ processModel CONSTANT)
+    Q_PROPERTY(QVariantList threads READ threads NOTIFY threadsChanged)
     Q_PROPERTY(QVariantMap system READ system NOTIFY systemChanged)
     Q_PROPERTY(QVariantList diskmounts READ diskmounts NOTIFY diskmountsChanged)
+    Q_PROPERTY(QAbstractListModel* mounts READ mounts CONSTANT)
     Q_PROPERTY(QVariantMap gpu READ gpu NOTIFY gpuChanged)
+    Q_PROPERTY(QVariantList gpus READ gpus NOTIFY gpusChanged)
+    Q_PROPERTY(QVariantMap pressure READ pressure NOTIFY pressureChanged)
+    Q_PROPERTY(QVariantList userSlices READ userSlices NOTIFY userSlicesChanged)
 
     Q_PROPERTY(int updateInterval READ updateInterval WRITE setUpdateInterval NOTIFY updateIntervalChanged)
     Q_PROPERTY(int maxProcesses READ maxProcesses WRITE setMaxProcesses NOTIFY maxProcessesChanged)
     Q_PROPERTY(QString sortBy READ sortBy WRITE setSortBy NOTIFY sortByChanged)
+    Q_PROPERTY(int threadsPid READ threadsPid WRITE setThreadsPid NOTIFY threadsPidChanged)
+    Q_PROPERTY(bool processGpu READ processGpu WRITE setProcessGpu NOTIFY processGpuChanged)
+    Q_PROPERTY(int historyLength READ historyLength WRITE setHistoryLength NOTIFY historyLengthChanged)
+    Q_PROPERTY(
+        qreal pressureThreshold READ pressureThreshold WRITE setPressureThreshold NOTIFY pressureThresholdChanged)
 
 public:
+    enum Collector {
+        Memory = CollectMemory,
+        Cpu = CollectCpu,
+        Network = CollectNetwork,
+        Disk = CollectDisk,
+        Processes = CollectProcesses,
+        Mounts = CollectMounts,
+        Gpu = CollectGpu,
+        Pressure = CollectPressure,
+        Cgroups = CollectCgroups,
+        AllCollectors = AllSysCollectors,
+    };
+    Q_DECLARE_FLAGS(Collectors, Collector)
+    Q_FLAG(Collectors)
+
     explicit SysMonitor(QObject* parent = nullptr);
     ~SysMonitor() override;
 
     QVariantMap memory() const;
     QVariantMap cpu() const;
+    qreal cpuUsage() const;
+    qreal cpuIowait() const;
+    qreal cpuSteal() const;
+    QList<qreal> cpuHistory() const;
+    QList<qreal> coreUsage() const;
+    QList<qreal> coreFrequencies() const;
+    QAbstractListModel* cpuCores() const;
     QVariantList network() const;
+    qreal netRxRate() const;
+    qreal netTxRate() const;
+    qint64 netRxBytes() const;
+    qint64 netTxBytes() const;
+    QList<qreal> netRxHistory() const;
+    QList<qreal> netTxHistory() const;
+    QAbstractListModel* netInterfaces() const;
     QVariantList disk() const;
+    qreal diskReadRate() const;
+    qreal diskWriteRate() const;
+    qreal diskIops() const;
+    qreal diskUtilization() const;
+    qreal diskLatency() const;
+    QList<qreal> diskReadHistory() const;
+    QList<qreal> diskWriteHistory() const;
+    QList<qreal> diskUtilizationHistory() const;
+    QAbstractListModel* diskDevices() const;
     QVariantList processes() const;
+    QAbstractListModel* processModel() const;
+    QVariantList threads() const;
     QVariantMap system() const;
     QVariantList diskmounts() const;
+    QAbstractListModel* mounts() const;
     QVariantMap gpu() const;
+    QVariantList gpus() const;
+    QVariantMap pressure() const;
+    QVariantList userSlices() const;
 
     int updateInterval() const;
     void setUpdateInterval(int interval);
@@ -49,8 +140,34 @@ public:
     QString sortBy() const;
     void setSortBy(const QString& sort);
 
+    int threadsPid() const;
+    void setThreadsPid(int pid);
+
+    /// Whether the process list carries per-process GPU time. Off by default
+    /// as it reads the fd tables of processes; always on while sortBy is "gpu".
+    bool processGpu() const;
+    void setProcessGpu(bool enabled);
+
+    int historyLength() const;
+    void setHistoryLength(int length);
+
+    /// Share (0-1) of a 2 s window that some tasks may stall on CPU, memory or
+    /// I/O before pressureStalled() is emitted, or 0 to disable. Delivered by
+    /// kernel PSI triggers, so it needs no subscription and costs nothing
+    /// while the system is calm; unprivileged triggers need Linux 6.5.
+    qreal pressureThreshold() const;
+    void setPressureThreshold(qreal threshold);
+
+    /// Subscribes to `collectors`, each sampled at least every `interval` ms,
+    /// or at the collector's default if 0 (updateInterval, 10 s for mounts).
+    /// Every ref() must be matched by an unref() with the same arguments.
+    void ref(Collectors collectors, int interval);
+    void unref(Collectors collectors, int interval);
+
+    /// Subscribe to / unsubscribe from every collector at its default interval.
     Q_INVOKABLE void start();
     Q_INVOKABLE void stop();
+    /// Samples every collector once, now.
     Q_INVOKABLE void updateAll();
     Q_INVOKABLE void updateSystemOnce();
     Q_INVOKABLE void updateGpuOnce();
@@ -58,58 +175,86 @@ public:
 signals:
     void memoryChanged();
     void cpuChanged();
+    void cpuLoadChanged();
     void networkChanged();
+    void netRatesChanged();
     void diskChanged();
+    void diskRatesChanged();
     void processesChanged();
+    void threadsChanged();
     void systemChanged();
     void diskmountsChanged();
     void gpuChanged();
+    void gpusChanged();
     void updateIntervalChanged();
     void maxProcessesChanged();
     void sortByChanged();
+    void threadsPidChanged();
+    void processGpuChanged();
+    void historyLengthChanged();
+    void pressureChanged();
+    void userSlicesChanged();
+    void pressureThresholdChanged();
+    void pressureStalled(const QString& resource);
 
 private:
-    void updateMemory();
-    void updateCpu();
-    void updateNetwork();
-    void updateDisk();
-    void updateProcesses();
-    void updateSystem();
-    void updateDiskmounts();
-    void updateGpu();
+    void applySnapshot(const SysSnapshot& snapshot);
+
+    [[nodiscard]] int collectorInterval(int index) const;
+    void reschedule();
+    void tick();
+    void requestSample(int collectors);
+
+    QThread m_thread;
+    SysSampler* m_sampler;
+    bool m_samplePending = false; // From requestSample() until sampleFinished()
 
     QTimer m_timer;
+    QElapsedTimer m_clock;
+    std::array<QList<int>, SysCollectorCount> m_subscriptions; // Requested intervals, one per ref
+    std::array<qint64, SysCollectorCount> m_lastSampled; // m_clock ms, -1 to sample on the next tick
+    int m_activeCollectors = 0;
+    int m_gpuInterval = 0;
+    bool m_started = false;
     int m_updateInterval = 2000;
     int m_maxProcesses = 100;
     QString m_sortBy = "cpu";
+    int m_threadsPid = -1;
+    bool m_processGpu = false;
+    int m_historyLength = 60;
+    qreal m_pressureThreshold = 0;
 
     QVariantMap m_memory;
     QVariantMap m_cpu;
+    CpuLoad m_cpuLoad;
+    QList<qreal> m_coreUsage;
+    QList<qreal> m_coreFrequencies;
+    RingBuffer<qreal> m_cpuHistory;
+    CpuCoreModel* m_cpuCores;
     QVariantList m_network;
+    NetInterfaceStats m_netTotal;
+    RingBuffer<qreal> m_netRxHistory;
+    RingBuffer<qreal> m_netTxHistory;
+    NetworkInterfaceModel* m_netInterfaces;
     QVariantList m_disk;
-    QVariantList m_processes;
+    DiskStats m_diskTotal;
+    RingBuffer<qreal> m_diskReadHistory;
+    RingBuffer<qreal> m_diskWriteHistory;
+    RingBuffer<qreal> m_diskUtilizationHistory;
+    DiskDeviceModel* m_diskDevices;
+    ProcessListModel* m_processModel;
+    mutable QVariantList m_processes; // Built from m_processModel on first read after a change
+    mutable bool m_processesStale = false;
+    QVariantList m_threads;
     QVariantMap m_system;
     QVariantList m_diskmounts;
+    MountListModel* m_mounts;
     QVariantMap m_gpu;
-
-    // Process State
-    struct ProcessInfo {
-        int pid;
-        int ppid;
-        double cpu;
-        double memoryPercent;
-        qint64 memoryKB;
-        QString command;
-        QString fullCommand;
-        qint64 utime;
-        qint64 stime;
-    };
-    QHash<int, ProcessInfo> m_lastProcesses;
-    
-    // Process CPU calculation helpers
-    qint64 m_sysUptime; 
-    long m_clockTicks;
-    qint64 m_memTotalKB = 1;
+    QVariantList m_gpus;
+    QVariantMap m_pressure;
+    QVariantList m_userSlices;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(SysMonitor::Collectors)
+
 } // namespace caelestia
@@ -0,0 +1,79 @@
+#include "sysmonitorref.hpp"
+
+namespace caelestia {
+
+SysMonitorRef::SysMonitorRef(QObject* parent)
+    : QObject(parent) {}
+
+SysMonitorRef::~SysMonitorRef() {
+    unref();
+}
+
+SysMonitor* SysMonitorRef::monitor() const {
+    return m_monitor;
+}
+
+void SysMonitorRef::setMonitor(SysMonitor* monitor) {
+    if (m_monitor == monitor) {
+        return;
+    }
+
+    unref();
+    m_monitor = monitor;
+    emit monitorChanged();
+    ref();
+}
+
+SysMonitor::Collectors SysMonitorRef::collectors() const {
+    return m_collectors;
+}
+
+void SysMonitorRef::setCollectors(SysMonitor::Collectors collectors) {
+    if (m_collectors == collectors) {
+        return;
+    }
+
+    unref();
+    m_collectors = collectors;
+    emit collectorsChanged();
+    ref();
+}
+
+int SysMonitorRef::interval() const {
+    return m_interval;
+}
+
+void SysMonitorRef::setInterval(int interval) {
+    interval = qMax(interval, 0);
+    if (m_interval == interval) {
+        return;
+    }
+
+    unref();
+    m_interval = interval;
+    emit intervalChanged();
+    ref();
+}
+
+void SysMonitorRef::classBegin() {
+    m_complete = false;
+}
+
+void SysMonitorRef::componentComplete() {
+    m_complete = true;
+    ref();
+}
+
+void SysMonitorRef::ref() {
+    if (m_complete && m_monitor && m_collectors.toInt() != 0) {
+        m_monitor->ref(m_collectors, m_interval);
+    }
+}
+
+void SysMonitorRef::unref() {
+    if (m_complete && m_monitor && m_collectors.toInt() != 0) {
+        m_monitor->unref(m_collectors, m_interval);
+    }
+}
+
+} // namespace caelestia
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "sysmonitor.hpp"
+
+#include <qobject.h>
+#include <qpointer.h>
+#include <qqmlintegration.h>
+#include <qqmlparserstatus.h>
+
+namespace caelestia {
+
+/// Keeps a subscription to some of SysMonitor's collectors for as long as it
+/// exists, like ServiceRef does for a Service:
+///
+///     SysMonitorRef {
+///         monitor: SysMonitor
+///         collectors: visible ? SysMonitor.Cpu | SysMonitor.Memory : 0
+///         interval: 1000
+///     }
+///
+/// Changing any property moves the subscription; it is taken once the
+/// component is complete, so initial assignments don't churn the schedule.
+class SysMonitorRef : public QObject, public QQmlParserStatus {
+    Q_OBJECT
+    QML_ELEMENT
+    Q_INTERFACES(QQmlParserStatus)
+
+    Q_PROPERTY(SysMonitor* monitor READ monitor WRITE setMonitor NOTIFY monitorChanged)
+    Q_PROPERTY(SysMonitor::Collectors collectors READ collectors WRITE setCollectors NOTIFY collectorsChanged)
+    Q_PROPERTY(int interval READ interval WRITE setInterval NOTIFY intervalChanged)
+
+public:
+    explicit SysMonitorRef(QObject* parent = nullptr);
+    ~SysMonitorRef() override;
+
+    [[nodiscard]] SysMonitor* monitor() const;
+    void setMonitor(SysMonitor* monitor);
+
+    [[nodiscard]] SysMonitor::Collectors collectors() const;
+    void setCollectors(SysMonitor::Collectors collectors);
+
+    /// Milliseconds, 0 for each collector's default.
+    [[nodiscard]] int interval() const;
+    void setInterval(int interval);
+
+    void classBegin() override;
+    void componentComplete() override;
+
+signals:
+    void monitorChanged();
+    void collectorsChanged();
+    void intervalChanged();
+
+private:
+    void ref();
+    void unref();
+
+    QPointer<SysMonitor> m_monitor; // Singletons can be destroyed before the refs to them
+    SysMonitor::Collectors m_collectors;
+    int m_interval = 0;
+    bool m_complete = true; // Until classBegin(), for instances created from C++
+};
+
+} // namespace caelestia
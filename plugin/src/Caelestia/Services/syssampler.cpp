@@ -0,0 +1,942 @@
+#include "syssampler.hpp"
+
+#include "nvidiatelemetry.hpp"
+#include "pcidevices.hpp"
+#include "procfs.hpp"
+
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDebug>
+#include <QSocketNotifier>
+#include <sys/sysinfo.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace caelestia {
+
+namespace {
+
+// Kernel counters only go backwards when the device was recreated or its
+// driver reset them, in which case everything since the reset is new
+qint64 counterDelta(qint64 current, qint64 previous) {
+    return current >= previous ? current - previous : current;
+}
+
+} // namespace
+
+SysSampler::SysSampler(QObject* parent)
+    : QObject(parent)
+    , m_nvidia(new NvidiaTelemetry(this))
+    , m_clockTicks(sysconf(_SC_CLK_TCK)) {
+    // Initialize default structures so QML doesn't crash on undefined properties
+    m_snapshot.gpu["type"] = "NONE";
+    m_snapshot.gpu["name"] = "";
+    m_snapshot.gpu["utilization"] = 0.0;
+    m_snapshot.gpu["temperature"] = 0.0;
+
+    m_snapshot.cpu["temperature"] = 0.0;
+    m_snapshot.cpu["model"] = "";
+    m_snapshot.cpu["frequency"] = 0.0;
+}
+
+void SysSampler::init() {
+    // Created here rather than in the constructor so it belongs to the worker thread
+    if (m_mountTable.watchFd() >= 0) {
+        m_mountWatch = new QSocketNotifier(m_mountTable.watchFd(), QSocketNotifier::Exception, this);
+        connect(m_mountWatch, &QSocketNotifier::activated, this, [this] {
+            m_mountTable.invalidate();
+            // Show a new or removed mount now rather than at the next sample
+            if (m_activeCollectors & CollectMounts) {
+                updateDiskmounts();
+                publish();
+            }
+        });
+    }
+
+    resolveCpuSensors();
+    updateSystemInfo(); // Static info
+    updateCpu(); // Initial CPU info
+    updateGpuInfo(); // Static GPU info
+    updateDiskmounts();
+    publish();
+}
+
+void SysSampler::probeSystem() {
+    updateSystemInfo();
+    publish();
+}
+
+void SysSampler::probeGpu() {
+    updateGpuInfo();
+    publish();
+}
+
+void SysSampler::sample(int collectors) {
+    // Process memory percentages are relative to MemTotal
+    if (collectors & (CollectMemory | CollectProcesses)) updateMemory();
+    if (collectors & CollectCpu) updateCpu();
+    if (collectors & CollectNetwork) updateNetwork();
+    if (collectors & CollectDisk) updateDisk();
+    if (collectors & CollectProcesses) updateProcesses();
+    if (collectors & CollectMounts) updateDiskmounts();
+    if (collectors & CollectGpu) updateGpu();
+    if (collectors & CollectPressure) updatePressure();
+    if (collectors & CollectCgroups) updateUserSlices();
+    publish();
+    emit sampleFinished();
+}
+
+void SysSampler::publish() {
+    emit sampled(m_snapshot);
+    // Loads and rates are deltas between two reads, so only the snapshot that
+    // follows a read carries them; probes in between must not repeat them
+    m_snapshot.coreLoads.clear();
+    m_snapshot.netInterfaces.clear();
+    m_snapshot.diskDevices.clear();
+}
+
+void SysSampler::setActiveCollectors(int collectors) {
+    // Rates are deltas since the previous read, which for a collector that was
+    // off spans the whole time it was off. Restart them, so the first read
+    // after it comes back only sets a baseline and publishes no rates.
+    const int resumed = collectors & ~m_activeCollectors;
+    if (resumed & CollectCpu) m_lastCpuTimes.clear();
+    if (resumed & CollectNetwork) m_netReadNs = 0;
+    if (resumed & CollectDisk) m_diskReadNs = 0;
+    if (resumed & CollectProcesses) {
+        m_processTable.restartWindow();
+        m_lastThreads.clear();
+    }
+    if (resumed & CollectCgroups) m_userSlices.restartWindow();
+    m_activeCollectors = collectors;
+
+    // An open nvidia-smi stream keeps a child process and the GPU awake, so
+    // only hold the channel while someone is watching the GPU
+    if (!(collectors & CollectGpu)) {
+        m_nvidia->close();
+    } else if (!m_nvidiaAddress.isEmpty() && m_nvidia->backend() == NvidiaTelemetry::Backend::None) {
+        m_nvidia->open(m_nvidiaAddress, m_updateInterval);
+    }
+}
+
+void SysSampler::setUpdateInterval(int interval) {
+    m_updateInterval = interval;
+    m_nvidia->setInterval(interval);
+}
+
+void SysSampler::setMaxProcesses(int max) {
+    m_maxProcesses = max;
+}
+
+void SysSampler::setThreadsPid(int pid) {
+    if (m_threadsPid == pid) return;
+    m_threadsPid = pid;
+    m_lastThreads.clear();
+    m_snapshot.threads.clear();
+}
+
+void SysSampler::setPressureThreshold(double threshold) {
+    // Notifiers must go before the descriptors they watch are closed
+    for (QSocketNotifier*& watch : m_pressureWatches) {
+        delete watch;
+        watch = nullptr;
+    }
+    if (!m_pressure.setThreshold(threshold)) {
+        qWarning() << "SysSampler::setPressureThreshold: no PSI trigger could be armed, stalls will only be seen"
+                   << "when pressure is sampled";
+        return;
+    }
+
+    for (int i = 0; i < Pressure::ResourceCount; ++i) {
+        const auto resource = static_cast<Pressure::Resource>(i);
+        const int fd = m_pressure.triggerFd(resource);
+        if (fd < 0) continue;
+        m_pressureWatches[i] = new QSocketNotifier(fd, QSocketNotifier::Exception, this);
+        connect(m_pressureWatches[i], &QSocketNotifier::activated, this, [this, resource] {
+            // Publish the averages that go with the stall, subscribed or not
+            updatePressure();
+            publish();
+            emit pressureStalled(QString::fromLatin1(Pressure::name(resource)));
+        });
+    }
+}
+
+void SysSampler::setSortBy(const QString& sort) {
+    // Resolved once here so ranking doesn't compare strings per comparison
+    if (sort == "cpu") m_sortKey = SortKey::Cpu;
+    else if (sort == "memory") m_sortKey = SortKey::Memory;
+    else if (sort == "pid") m_sortKey = SortKey::Pid;
+    else if (sort == "tree") m_sortKey = SortKey::TreeCpu;
+    else if (sort == "gpu") m_sortKey = SortKey::Gpu;
+    else m_sortKey = SortKey::Name;
+    updateGpuTracking();
+}
+
+void SysSampler::setProcessGpu(bool enabled) {
+    m_processGpu = enabled;
+    updateGpuTracking();
+}
+
+void SysSampler::updateGpuTracking() {
+    // Per-process GPU time means walking fd tables, so only collect it while
+    // it is shown or ranked by
+    m_processTable.setTrackGpu(!m_drmGpus.isEmpty() && (m_processGpu || m_sortKey == SortKey::Gpu));
+}
+
+void SysSampler::resolveCpuSensors() {
+    // Sensor paths don't change while running, so find them once instead of
+    // rescanning /sys/class/hwmon every tick
+    QDir hwmonDir("/sys/class/hwmon");
+    for (const QString& hwmonD : hwmonDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QFile nameF(hwmonDir.absoluteFilePath(hwmonD) + "/name");
+        if (!nameF.open(QIODevice::ReadOnly | QIODevice::Text)) continue;
+
+        QString hwName = QString::fromUtf8(nameF.readAll().trimmed());
+        if (hwName == "coretemp" || hwName == "k10temp" || hwName == "zenpower") {
+            QDir hwD(hwmonDir.absoluteFilePath(hwmonD));
+            QStringList inputs = hwD.entryList(QStringList() << "temp*_input", QDir::Files);
+            if (!inputs.isEmpty()) {
+                m_cpuTempFile.setPath(hwD.absoluteFilePath(inputs.first()).toStdString());
+                return;
+            }
+        }
+    }
+
+    m_cpuTempFile.setPath("/sys/class/thermal/thermal_zone0/temp");
+}
+
+void SysSampler::updateMemory() {
+    std::string_view text = m_meminfoFile.read();
+    if (text.empty()) return;
+
+    qint64 memTotal = 0, memFree = 0, memAvailable = 0;
+    qint64 buffers = 0, cached = 0, shared = 0;
+    qint64 swapTotal = 0, swapFree = 0;
+
+    std::string_view line;
+    while (procfs::nextLine(text, line)) {
+        const std::string_view key = procfs::nextField(line);
+        qint64 val = 0;
+        if (!procfs::nextInt(line, val)) continue;
+
+        if (key == "MemTotal:") memTotal = val;
+        else if (key == "MemFree:") memFree = val;
+        else if (key == "MemAvailable:") memAvailable = val;
+        else if (key == "Buffers:") buffers = val;
+        else if (key == "Cached:") cached = val;
+        else if (key == "Shmem:") shared = val;
+        else if (key == "SwapTotal:") swapTotal = val;
+        else if (key == "SwapFree:") swapFree = val;
+    }
+
+    m_memTotalKB = memTotal > 0 ? memTotal : 1;
+
+    QVariantMap newMem;
+    newMem.insert("total", memTotal);
+    newMem.insert("free", memFree);
+    newMem.insert("available", memAvailable);
+    newMem.insert("buffers", buffers);
+    newMem.insert("cached", cached);
+    newMem.insert("shared", shared);
+    newMem.insert("swaptotal", swapTotal);
+    newMem.insert("swapfree", swapFree);
+
+    m_snapshot.memory = newMem;
+}
+
+void SysSampler::updateCpu() {
+    // 1. Parse /proc/stat for usage and core count
+    std::string_view text = m_statFile.read();
+    if (text.empty()) return;
+
+    int count = 0;
+    m_cpuTimes.clear();
+
+    std::string_view line;
+    while (procfs::nextLine(text, line)) {
+        const std::string_view key = procfs::nextField(line);
+        if (!key.starts_with("cpu")) continue;
+
+        // user nice system idle iowait irq softirq steal guest guest_nice; guest time
+        // is already counted in user and nice, so only the first eight add up to the total
+        CpuTimes times;
+        qint64 id = -1;
+        if (key.size() > 3 && procfs::parseInt(key.substr(3), id)) times.cpu = static_cast<int>(id);
+        qint64 val = 0;
+        for (int i = 0; i < 8 && procfs::nextInt(line, val); ++i) {
+            times.total += val;
+            if (i == 3 || i == 4) times.idle += val;
+            if (i == 4) times.iowait = val;
+            if (i == 7) times.steal = val;
+        }
+        m_cpuTimes.push_back(times);
+        if (times.cpu >= 0) count++;
+    }
+
+    // Utilisation over the interval since the previous read. The first read (and
+    // any read after a CPU was hotplugged) has nothing to diff against, so it
+    // publishes no loads rather than the average since boot.
+    const auto loadBetween = [](const CpuTimes& prev, const CpuTimes& cur) {
+        const qint64 elapsed = cur.total - prev.total;
+        if (elapsed <= 0) return CpuLoad{};
+        const auto dt = static_cast<qreal>(elapsed);
+        return CpuLoad{ std::clamp(1.0 - static_cast<qreal>(cur.idle - prev.idle) / dt, 0.0, 1.0),
+            std::clamp(static_cast<qreal>(cur.iowait - prev.iowait) / dt, 0.0, 1.0),
+            std::clamp(static_cast<qreal>(cur.steal - prev.steal) / dt, 0.0, 1.0) };
+    };
+
+    if (std::ranges::equal(m_lastCpuTimes, m_cpuTimes, {}, &CpuTimes::cpu, &CpuTimes::cpu)) {
+        m_snapshot.coreLoads.reserve(count);
+        for (std::size_t i = 0; i < m_cpuTimes.size(); ++i) {
+            const CpuLoad load = loadBetween(m_lastCpuTimes[i], m_cpuTimes[i]);
+            if (m_cpuTimes[i].cpu < 0) {
+                m_snapshot.cpuLoad = load;
+            } else {
+                m_snapshot.coreLoads.append(load);
+            }
+        }
+    }
+    std::swap(m_lastCpuTimes, m_cpuTimes);
+
+    updateCoreFrequencies();
+
+    QVariantMap newCpu = m_snapshot.cpu;
+    newCpu.insert("count", count); // Loads are published natively, see cpuLoad and coreLoads
+
+    // 2. Frequency, averaged over the cores cpufreq reports on
+    double mhzSum = 0.0;
+    int mhzCount = 0;
+    for (const qreal mhz : std::as_const(m_snapshot.coreFrequencies)) {
+        if (mhz <= 0) continue;
+        mhzSum += mhz;
+        ++mhzCount;
+    }
+    if (mhzCount > 0) newCpu.insert("frequency", mhzSum / static_cast<double>(mhzCount));
+
+    // 3. Model, from /proc/cpuinfo. The kernel generates that file for every
+    // CPU on each read, which is slow on large machines, so it is read once.
+    if (!m_cpuInfoRead) {
+        m_cpuInfoRead = true;
+        readCpuInfo(newCpu, mhzCount == 0);
+    }
+
+    // 4. Temperature
+    double temp = 0.0;
+    if (m_cpuTempFile.readDouble(temp)) {
+        newCpu.insert("temperature", temp / 1000.0);
+    } else if (!newCpu.contains("temperature")) {
+        newCpu.insert("temperature", 0.0);
+    }
+
+    m_snapshot.cpu = newCpu;
+}
+
+void SysSampler::readCpuInfo(QVariantMap& cpu, bool needFrequency) {
+    // x86 names the model per processor; ARM kernels may only report the SoC
+    // as "Hardware"
+    procfs::ProcFile file("/proc/cpuinfo");
+    std::string_view text = file.read();
+    std::string_view line;
+    std::string_view model;
+    std::string_view hardware;
+    while (procfs::nextLine(text, line)) {
+        const auto colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+        const std::string_view key = procfs::trimmed(line.substr(0, colon));
+        const std::string_view value = procfs::trimmed(line.substr(colon + 1));
+
+        if (key == "cpu MHz" && needFrequency) {
+            // Without cpufreq (e.g. in most VMs) this is the nominal clock and
+            // doesn't change, so it stands in for the live frequency
+            double mhz = 0.0;
+            if (procfs::parseDouble(value, mhz)) cpu.insert("frequency", mhz);
+            needFrequency = false;
+        } else if (key == "model name" && model.empty()) {
+            model = value;
+        } else if (key == "Hardware" && hardware.empty()) {
+            hardware = value;
+        }
+    }
+
+    const std::string_view name = model.empty() ? hardware : model;
+    if (!name.empty()) cpu.insert("model", QString::fromUtf8(name.data(), static_cast<qsizetype>(name.size())));
+}
+
+void SysSampler::updateCoreFrequencies() {
+    // cpufreq nodes are per logical CPU and only change on hotplug, which also
+    // changes the set of cpuN lines in /proc/stat
+    std::vector<int> ids;
+    ids.reserve(m_lastCpuTimes.size());
+    for (const auto& times : m_lastCpuTimes) {
+        if (times.cpu >= 0) ids.push_back(times.cpu);
+    }
+    if (ids != m_coreFreqIds) {
+        m_coreFreqFiles.clear();
+        m_coreFreqFiles.reserve(ids.size());
+        for (const int id : ids) {
+            m_coreFreqFiles.emplace_back(
+                "/sys/devices/system/cpu/cpu" + std::to_string(id) + "/cpufreq/scaling_cur_freq");
+        }
+        m_coreFreqIds = std::move(ids);
+    }
+
+    QList<qreal> freqs;
+    freqs.reserve(static_cast<qsizetype>(m_coreFreqFiles.size()));
+    for (auto& file : m_coreFreqFiles) {
+        qint64 khz = 0;
+        freqs.append(file.readInt(khz) ? static_cast<qreal>(khz) / 1000.0 : 0.0);
+    }
+    m_snapshot.coreFrequencies = freqs;
+}
+
+void SysSampler::updateNetwork() {
+    std::string_view text = m_netDevFile.read();
+    if (text.empty()) return;
+
+    const qint64 now = procfs::monotonicNs();
+    const double elapsed = m_netReadNs > 0 ? static_cast<double>(now - m_netReadNs) / 1e9 : 0;
+    m_netReadNs = now;
+    const quint32 generation = ++m_netGeneration;
+
+    std::string_view line;
+    procfs::nextLine(text, line); // skip header
+    procfs::nextLine(text, line);
+
+    QVariantList newNet;
+    QList<NetInterfaceStats> interfaces;
+    NetInterfaceStats total;
+    total.name = "total";
+    while (procfs::nextLine(text, line)) {
+        // "  eth0: rx_bytes rx_packets ... tx_bytes ..." - large counters may touch the colon
+        const auto colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+        const std::string_view rawName = procfs::trimmed(line.substr(0, colon));
+
+        std::string_view stats = line.substr(colon + 1);
+        qint64 fields[9] = {};
+        int parsed = 0;
+        while (parsed < 9 && procfs::nextInt(stats, fields[parsed])) ++parsed;
+        if (parsed < 9) continue;
+
+        const QString name = QString::fromUtf8(rawName.data(), static_cast<qsizetype>(rawName.size()));
+        auto it = m_netCounters.find(name);
+        const bool known = it != m_netCounters.end();
+        if (!known) {
+            // New or hotplugged interface: classify it once and start from its
+            // current counters, so it shows no burst of past traffic
+            it = m_netCounters.insert(name, { networkKind(name), fields[0], fields[8], 0, 0, 0 });
+        }
+        NetCounters& counters = it.value();
+        counters.generation = generation;
+
+        const qint64 rxDelta = counterDelta(fields[0], counters.rx);
+        const qint64 txDelta = counterDelta(fields[8], counters.tx);
+        counters.rx = fields[0];
+        counters.tx = fields[8];
+        counters.rxBytes += rxDelta;
+        counters.txBytes += txDelta;
+
+        NetInterfaceStats iface;
+        iface.name = name;
+        iface.kind = counters.kind;
+        iface.rxBytes = counters.rxBytes;
+        iface.txBytes = counters.txBytes;
+        if (known && elapsed > 0) {
+            iface.rxRate = static_cast<double>(rxDelta) / elapsed;
+            iface.txRate = static_cast<double>(txDelta) / elapsed;
+        }
+        interfaces.append(iface);
+
+        if (iface.kind == "loopback" || iface.kind == "virtual") continue;
+
+        total.rxBytes += iface.rxBytes;
+        total.txBytes += iface.txBytes;
+        total.rxRate += iface.rxRate;
+        total.txRate += iface.txRate;
+
+        QVariantMap legacy;
+        legacy["name"] = name;
+        legacy["rx"] = fields[0];
+        legacy["tx"] = fields[8];
+        newNet.append(legacy);
+    }
+
+    m_netCounters.removeIf([generation](const QHash<QString, NetCounters>::iterator it) {
+        return it.value().generation != generation;
+    });
+
+    m_snapshot.network = newNet;
+    // Without a previous read there are no rates, and publishing zeros would
+    // put a false dip into the histories
+    if (elapsed > 0) {
+        m_snapshot.netInterfaces = interfaces;
+        m_snapshot.netTotal = total;
+    }
+}
+
+QString SysSampler::networkKind(const QString& name) {
+    const QString path = "/sys/class/net/" + name;
+
+    // ARPHRD_* from <linux/if_arp.h>
+    procfs::ProcFile typeFile((path + "/type").toStdString());
+    qint64 type = -1;
+    if (!typeFile.readInt(type)) return "other";
+    if (type == 772) return "loopback";
+
+    // Only interfaces backed by hardware have a device link; bridges, veths,
+    // tunnels and VPNs don't
+    if (!QFileInfo(path + "/device").isSymLink()) return "virtual";
+    if (QFileInfo::exists(path + "/wireless") || QFileInfo::exists(path + "/phy80211")) return "wireless";
+    return type == 1 ? "ethernet" : "other";
+}
+
+void SysSampler::updateDisk() {
+    std::string_view text = m_diskstatsFile.read();
+    if (text.empty()) return;
+
+    const qint64 now = procfs::monotonicNs();
+    const double elapsed = m_diskReadNs > 0 ? static_cast<double>(now - m_diskReadNs) / 1e9 : 0;
+    m_diskReadNs = now;
+    const quint32 generation = ++m_diskGeneration;
+
+    QVariantList newDisk;
+    QList<DiskStats> devices;
+    DiskStats total;
+    total.name = total.label = "total";
+    qint64 totalIos = 0;
+    qint64 totalIoMs = 0;
+
+    std::string_view line;
+    while (procfs::nextLine(text, line)) {
+        procfs::nextField(line); // major
+        procfs::nextField(line); // minor
+        const std::string_view rawName = procfs::nextField(line);
+
+        // reads, reads merged, sectors read, ms reading, writes, writes merged,
+        // sectors written, ms writing, I/Os in flight, ms doing I/O
+        qint64 fields[10] = {};
+        int parsed = 0;
+        while (parsed < 10 && procfs::nextInt(line, fields[parsed])) ++parsed;
+        if (parsed < 10) continue;
+
+        const QString name = QString::fromUtf8(rawName.data(), static_cast<qsizetype>(rawName.size()));
+        auto it = m_diskCounters.find(name);
+        const bool known = it != m_diskCounters.end();
+        if (!known) it = m_diskCounters.insert(name, diskInfo(name));
+        DiskCounters& counters = it.value();
+        counters.generation = generation;
+
+        const qint64 reads = counterDelta(fields[0], counters.reads);
+        const qint64 sectorsRead = counterDelta(fields[2], counters.sectorsRead);
+        const qint64 readMs = counterDelta(fields[3], counters.readMs);
+        const qint64 writes = counterDelta(fields[4], counters.writes);
+        const qint64 sectorsWritten = counterDelta(fields[6], counters.sectorsWritten);
+        const qint64 writeMs = counterDelta(fields[7], counters.writeMs);
+        const qint64 ioTicks = counterDelta(fields[9], counters.ioTicks);
+        counters.reads = fields[0];
+        counters.sectorsRead = fields[2];
+        counters.readMs = fields[3];
+        counters.writes = fields[4];
+        counters.sectorsWritten = fields[6];
+        counters.writeMs = fields[7];
+        counters.ioTicks = fields[9];
+
+        if (!counters.tracked) continue;
+
+        DiskStats disk;
+        disk.name = name;
+        disk.label = counters.label;
+        disk.kind = counters.kind;
+        // A new device starts from its current counters, like a new interface
+        if (known && elapsed > 0) {
+            // diskstats counts 512-byte sectors regardless of the device's block size
+            disk.readRate = static_cast<double>(sectorsRead) * 512.0 / elapsed;
+            disk.writeRate = static_cast<double>(sectorsWritten) * 512.0 / elapsed;
+            disk.readIops = static_cast<double>(reads) / elapsed;
+            disk.writeIops = static_cast<double>(writes) / elapsed;
+            disk.utilization = qMin(static_cast<double>(ioTicks) / (elapsed * 1000.0), 1.0);
+            if (reads + writes > 0) {
+                disk.latency = static_cast<double>(readMs + writeMs) / static_cast<double>(reads + writes);
+            }
+        }
+        devices.append(disk);
+
+        if (disk.kind != "disk") continue;
+
+        total.readRate += disk.readRate;
+        total.writeRate += disk.writeRate;
+        total.readIops += disk.readIops;
+        total.writeIops += disk.writeIops;
+        total.utilization = qMax(total.utilization, disk.utilization);
+        if (known) {
+            totalIos += reads + writes;
+            totalIoMs += readMs + writeMs;
+        }
+
+        QVariantMap legacy;
+        legacy["name"] = name;
+        legacy["read"] = fields[2]; // sectors read
+        legacy["write"] = fields[6]; // sectors written
+        newDisk.append(legacy);
+    }
+    if (totalIos > 0) total.latency = static_cast<double>(totalIoMs) / static_cast<double>(totalIos);
+
+    m_diskCounters.removeIf([generation](const QHash<QString, DiskCounters>::iterator it) {
+        return it.value().generation != generation;
+    });
+
+    m_snapshot.disk = newDisk;
+    if (elapsed > 0) { // See updateNetwork()
+        m_snapshot.diskDevices = devices;
+        m_snapshot.diskTotal = total;
+    }
+}
+
+SysSampler::DiskCounters SysSampler::diskInfo(const QString& name) {
+    DiskCounters info;
+
+    // Only whole disks are listed in /sys/block; partitions live beneath
+    // their disk. Loop devices are file I/O already seen on the disk holding
+    // the file, and empty ones (unused loop, ram, drives without media)
+    // never do anything
+    const QString path = "/sys/block/" + name;
+    procfs::ProcFile sizeFile((path + "/size").toStdString());
+    qint64 sectors = 0;
+    if (!sizeFile.readInt(sectors) || sectors == 0 || QFileInfo::exists(path + "/loop")) return info;
+
+    info.tracked = true;
+    info.kind = QFileInfo(path + "/device").isSymLink() ? "disk" : "virtual";
+    info.label = name;
+
+    procfs::ProcFile dmName((path + "/dm/name").toStdString());
+    const std::string_view label = procfs::trimmed(dmName.read());
+    if (!label.empty()) info.label = QString::fromUtf8(label.data(), static_cast<qsizetype>(label.size()));
+
+    return info;
+}
+
+void SysSampler::updateSystem() {
+    std::string_view loadavg = m_loadavgFile.read();
+    if (!loadavg.empty()) {
+        // "0.52 0.58 0.59 1/467 12345" -> first three fields
+        std::size_t end = 0;
+        for (int i = 0; i < 3 && end != std::string_view::npos; ++i) {
+            end = loadavg.find(' ', end == 0 ? 0 : end + 1);
+        }
+        const std::string_view avg = procfs::trimmed(loadavg.substr(0, end));
+        m_snapshot.system["loadavg"] = QString::fromUtf8(avg.data(), static_cast<qsizetype>(avg.size()));
+    }
+
+    struct sysinfo si;
+    if (sysinfo(&si) == 0) {
+        m_sysUptime = si.uptime;
+        m_snapshot.system["processes"] = si.procs;
+    }
+}
+
+void SysSampler::updateSystemInfo() {
+    updateSystem(); // Grab first uptime
+    
+    // Set static system values
+    QFile rel("/etc/os-release");
+    if (rel.open(QIODevice::ReadOnly)) {
+        QTextStream in(&rel);
+        while(!in.atEnd()) {
+            QString line = in.readLine();
+            if (line.startsWith("PRETTY_NAME=")) {
+                m_snapshot.system["distro"] = line.section("=", 1).replace("\"", "");
+                break;
+            }
+        }
+    }
+    
+    struct utsname un;
+    if (uname(&un) == 0) {
+        m_snapshot.system["kernel"] = QString::fromUtf8(un.release);
+        m_snapshot.system["arch"] = QString::fromUtf8(un.machine);
+    }
+    
+    char hostname[256];
+    if (gethostname(hostname, sizeof(hostname)) == 0) m_snapshot.system["hostname"] = QString::fromUtf8(hostname);
+    
+    QFile dm("/sys/class/dmi/id/board_vendor");
+    if (dm.open(QIODevice::ReadOnly)) m_snapshot.system["motherboard"] = QString::fromUtf8(dm.readAll().trimmed());
+}
+
+void SysSampler::updateProcesses() {
+    updateSystem(); // Needed for uptime calculation
+
+    if (!m_processTable.refresh()) return;
+
+    m_ranked.clear();
+    m_ranked.reserve(static_cast<std::size_t>(m_processTable.size()));
+    const double ticksPerPercent = static_cast<double>(m_clockTicks) * m_processTable.elapsed() / 100.0;
+    const double nsPerPercent = m_processTable.elapsed() * 1e7;
+    for (const ProcessEntry& entry : m_processTable.processes()) {
+        const double cpu = ticksPerPercent > 0 ? static_cast<double>(entry.cpuTicksDelta) / ticksPerPercent : 0.0;
+        const double memoryPercent = static_cast<double>(entry.rssKB) / static_cast<double>(m_memTotalKB) * 100.0;
+        const double gpu = nsPerPercent > 0 ? static_cast<double>(entry.gpuTimeDelta) / nsPerPercent : 0.0;
+        m_ranked.push_back({ &entry, 0, cpu, memoryPercent, gpu, cpu, entry.rssKB });
+    }
+
+    aggregateProcessTree();
+
+    for (RankedProcess& r : m_ranked) {
+        switch (m_sortKey) {
+        case SortKey::Cpu:
+            r.key = r.cpu;
+            break;
+        case SortKey::Memory:
+            r.key = r.memoryPercent;
+            break;
+        case SortKey::Pid:
+            r.key = r.entry->pid;
+            break;
+        case SortKey::TreeCpu:
+            r.key = r.treeCpu;
+            break;
+        case SortKey::Gpu:
+            r.key = r.gpu;
+            break;
+        case SortKey::Name:
+            break;
+        }
+    }
+
+    // Only the top maxProcesses are published, so partition those off in linear
+    // time and sort just that prefix. Ties break on pid so rows don't swap
+    // places between ticks for no reason.
+    const auto limit = std::min(static_cast<std::size_t>(qMax(m_maxProcesses, 0)), m_ranked.size());
+    const auto top = m_ranked.begin() + static_cast<std::ptrdiff_t>(limit);
+    const auto rank = [this](const RankedProcess& a, const RankedProcess& b) {
+        if (m_sortKey == SortKey::Name) {
+            if (a.entry->command != b.entry->command) return a.entry->command < b.entry->command;
+        } else if (a.key != b.key) {
+            return a.key > b.key;
+        }
+        return a.entry->pid < b.entry->pid;
+    };
+    if (top != m_ranked.end()) std::nth_element(m_ranked.begin(), top, m_ranked.end(), rank);
+    std::sort(m_ranked.begin(), top, rank);
+
+    QList<ProcessRow> rows;
+    rows.reserve(static_cast<qsizetype>(limit));
+    for (auto it = m_ranked.begin(); it != top; ++it) {
+        const ProcessEntry& entry = *it->entry;
+        rows.append({ entry.pid, entry.ppid, entry.startTime, it->cpu, it->memoryPercent, entry.rssKB, it->gpu,
+            it->treeCpu, it->treeMemoryKB, entry.command, entry.fullCommand });
+    }
+
+    m_snapshot.processes = rows;
+
+    updateThreads();
+}
+
+void SysSampler::aggregateProcessTree() {
+    m_rankedByPid.clear();
+    m_rankedByPid.reserve(static_cast<qsizetype>(m_ranked.size()));
+    for (std::size_t i = 0; i < m_ranked.size(); ++i) {
+        m_rankedByPid.insert(m_ranked[i].entry->pid, i);
+    }
+
+    // Charge each process to every ancestor, so a build job's root shows what
+    // the whole job costs. Trees are shallow, so walking up per process beats
+    // building child lists. The depth cap only guards against a ppid cycle
+    // from a pid being reused mid-scan.
+    for (const RankedProcess& r : m_ranked) {
+        int ppid = r.entry->ppid;
+        for (int depth = 0; ppid > 0 && depth < 256; ++depth) {
+            const auto it = m_rankedByPid.constFind(ppid);
+            if (it == m_rankedByPid.constEnd()) break;
+            RankedProcess& ancestor = m_ranked[it.value()];
+            ancestor.treeCpu += r.cpu;
+            ancestor.treeMemoryKB += r.entry->rssKB;
+            ppid = ancestor.entry->ppid;
+        }
+    }
+}
+
+void SysSampler::updateThreads() {
+    if (m_threadsPid <= 0) return;
+
+    const double ticksPerPercent = static_cast<double>(m_clockTicks) * m_processTable.elapsed() / 100.0;
+    QVariantList threads;
+    if (m_processTable.readThreads(m_threadsPid, m_threads)) {
+        std::vector<std::pair<double, const ThreadEntry*>> ranked;
+        ranked.reserve(m_threads.size());
+        for (const ThreadEntry& thread : m_threads) {
+            double cpu = 0;
+            const auto last = m_lastThreads.constFind(thread.tid);
+            if (last != m_lastThreads.constEnd() && last->startTime == thread.startTime && ticksPerPercent > 0) {
+                cpu = static_cast<double>(qMax(thread.cpuTicks - last->cpuTicks, qint64(0))) / ticksPerPercent;
+            }
+            ranked.emplace_back(cpu, &thread);
+        }
+        std::ranges::sort(ranked, [](const auto& a, const auto& b) {
+            return a.first != b.first ? a.first > b.first : a.second->tid < b.second->tid;
+        });
+
+        threads.reserve(static_cast<qsizetype>(ranked.size()));
+        for (const auto& [cpu, thread] : ranked) {
+            QVariantMap t;
+            t["tid"] = thread->tid;
+            t["name"] = thread->name;
+            t["cpu"] = cpu;
+            threads.append(t);
+        }
+    }
+
+    m_lastThreads.clear();
+    for (const ThreadEntry& thread : m_threads) {
+        m_lastThreads.insert(thread.tid, thread);
+    }
+    m_snapshot.threads = threads;
+}
+
+void SysSampler::updateDiskmounts() {
+    // Cheap unless the mount table changed or usage is due; see MountTable
+    if (!m_mountTable.update()) return;
+
+    const QList<MountStats>& mounts = m_mountTable.mounts();
+    QVariantList newMounts;
+    newMounts.reserve(mounts.size());
+    for (const MountStats& mount : mounts) {
+        QVariantMap m;
+        m["device"] = mount.device;
+        m["mount"] = mount.mount;
+        m["fstype"] = mount.fstype;
+        m["size"] = mount.size; // bytes
+        m["used"] = mount.used;
+        m["avail"] = mount.avail;
+        m["percent"] = mount.percent * 100.0;
+        m["responsive"] = mount.responsive;
+        newMounts.append(m);
+    }
+
+    m_snapshot.mounts = mounts;
+    m_snapshot.diskmounts = newMounts;
+}
+
+void SysSampler::updatePressure() {
+    if (!m_pressure.isAvailable()) return;
+    m_pressure.sample();
+
+    QVariantMap pressure;
+    for (int i = 0; i < Pressure::ResourceCount; ++i) {
+        const auto resource = static_cast<Pressure::Resource>(i);
+        pressure[Pressure::name(resource)] = m_pressure.stats(resource).toVariantMap();
+    }
+    m_snapshot.pressure = pressure;
+}
+
+void SysSampler::updateUserSlices() {
+    m_userSlices.sample();
+
+    QVariantList slices;
+    slices.reserve(m_userSlices.slices().size());
+    for (const UserSliceStats& slice : m_userSlices.slices()) {
+        slices.append(slice.toVariantMap());
+    }
+    m_snapshot.userSlices = slices;
+}
+
+void SysSampler::updateGpuInfo() {
+    QString gType = "NONE";
+    QString gName = "";
+
+    // 1. NVIDIA telemetry needs the proprietary driver (neither NVML nor
+    // nvidia-smi work with nouveau), so it's NVIDIA only if a display device is
+    // bound to it and a telemetry channel to it could be opened.
+    // Otherwise fall back to /sys/class/drm generic polling.
+    m_drmGpus.resolve();
+    updateGpuTracking();
+
+    const QList<pci::Device> devices = pci::displayDevices();
+    const pci::Device* gpu = nullptr;
+    m_nvidiaAddress.clear();
+    for (const pci::Device& d : devices) {
+        if (d.vendor == pci::VendorNvidia && d.driver == "nvidia") {
+            if (m_nvidia->open(d.address, m_updateInterval)) {
+                gType = "NVIDIA";
+                gpu = &d;
+                m_nvidiaAddress = d.address;
+            }
+            break;
+        }
+    }
+    // The address is kept, so setActiveCollectors() can reopen the channel
+    if (gType != "NVIDIA" || !(m_activeCollectors & CollectGpu)) m_nvidia->close();
+
+    if (gType == "NONE") {
+        if (m_drmGpus.reportsUtilization()) gType = "GENERIC";
+
+        // Name the GPU that's actually polled if there is one, else the boot VGA device
+        for (const pci::Device& d : devices) {
+            if (QFile::exists(d.sysfsPath + "/gpu_busy_percent")) {
+                gpu = &d;
+                break;
+            }
+        }
+        if (!gpu && !devices.isEmpty()) gpu = &devices.first();
+    }
+
+    // 2. Name from pci.ids, as lspci shows it
+    if (gpu) gName = pci::marketingName(gpu->vendor, gpu->device);
+
+    qDebug() << "[SysMonitor] updateGpuOnce result -" << "Type:" << gType << "Name:" << gName;
+
+    m_snapshot.gpu["type"] = gType;
+    m_snapshot.gpu["name"] = gName;
+    m_snapshot.gpu["utilization"] = 0.0;
+    m_snapshot.gpu["temperature"] = 0.0;
+}
+
+void SysSampler::updateGpu() {
+    m_drmGpus.sample();
+
+    const NvidiaSample nvidia = m_nvidiaAddress.isEmpty() ? NvidiaSample{} : m_nvidia->latest();
+
+    QVariantList gpus;
+    for (const GpuStats& stats : m_drmGpus.stats()) {
+        QVariantMap g = stats.toVariantMap();
+        if (stats.address == m_nvidiaAddress && nvidia.valid) {
+            // The NVIDIA driver exposes none of this through sysfs
+            g["utilization"] = nvidia.utilization;
+            g["temperature"] = nvidia.temperature;
+            g["memoryUsed"] = nvidia.memoryUsedKB;
+            g["memoryTotal"] = nvidia.memoryTotalKB;
+            g["power"] = nvidia.power;
+        }
+        gpus.append(g);
+    }
+    m_snapshot.gpus = gpus;
+
+    QString gType = m_snapshot.gpu["type"].toString();
+    if (gType == "NONE") return;
+
+    QVariantMap newGpu = m_snapshot.gpu;
+
+    if (gType == "NVIDIA") {
+        if (nvidia.valid) {
+            newGpu["utilization"] = nvidia.utilization;
+            newGpu["temperature"] = nvidia.temperature;
+            newGpu["memoryUsed"] = nvidia.memoryUsedKB;
+            newGpu["memoryTotal"] = nvidia.memoryTotalKB;
+            newGpu["power"] = nvidia.power;
+        }
+    } else if (gType == "GENERIC") {
+        const double usage = m_drmGpus.meanUtilization();
+        if (usage >= 0) newGpu["utilization"] = usage;
+        newGpu["temperature"] = m_drmGpus.temperature();
+    }
+
+    m_snapshot.gpu = newGpu;
+}
+
+} // namespace caelestia
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "drmgpus.hpp"
+#include "mounttable.hpp"
+#include "pressure.hpp"
+#include "procfs.hpp"
+#include "proctable.hpp"
+#include "userslices.hpp"
+
+#include <qhash.h>
+#include <qobject.h>
+#include <qvariant.h>
+
+#include <array>
+#include <vector>
+
+class QSocketNotifier;
+
+namespace caelestia {
+
+class NvidiaTelemetry;
+
+/// Groups of metrics that are collected together, as bits of the mask taken by
+/// SysSampler::sample(). Exposed to QML as SysMonitor::Collector.
+enum SysCollector : int {
+    CollectMemory = 1 << 0,
+    CollectCpu = 1 << 1,
+    CollectNetwork = 1 << 2,
+    CollectDisk = 1 << 3,
+    CollectProcesses = 1 << 4, // Also threads and loadavg
+    CollectMounts = 1 << 5,
+    CollectGpu = 1 << 6,
+    CollectPressure = 1 << 7,
+    CollectCgroups = 1 << 8, // Per-user systemd slices
+};
+constexpr int SysCollectorCount = 9;
+constexpr int AllSysCollectors = (1 << SysCollectorCount) - 1;
+
+/// Share of one CPU (or of all of them) spent busy, waiting on I/O and
+/// stolen by the hypervisor over the last sampling interval, each in [0, 1].
+struct CpuLoad {
+    qreal usage = 0;
+    qreal iowait = 0;
+    qreal steal = 0;
+
+    bool operator==(const CpuLoad& other) const = default;
+};
+
+/// One row of the published process list.
+struct ProcessRow {
+    int pid = 0;
+    int ppid = 0;
+    qint64 startTime = 0;
+    double cpu = 0;
+    double memoryPercent = 0;
+    qint64 memoryKB = 0;
+    double gpu = 0; // % of one GPU engine, summed over engines and GPUs
+    double treeCpu = 0; // Including all descendants
+    qint64 treeMemoryKB = 0;
+    QString command;
+    QString fullCommand;
+
+    bool operator==(const ProcessRow& other) const = default;
+};
+
+/// Traffic through one network interface, or summed over the physical ones.
+struct NetInterfaceStats {
+    QString name;
+    QString kind; // "ethernet", "wireless", "other" (physical), "virtual" or "loopback"
+    qint64 rxBytes = 0; // Since tracking started, carried across counter resets
+    qint64 txBytes = 0;
+    double rxRate = 0; // B/s over the last sampling interval
+    double txRate = 0;
+
+    bool operator==(const NetInterfaceStats& other) const = default;
+};
+
+/// I/O on one whole block device over the last sampling interval, or summed
+/// over the physical ones.
+struct DiskStats {
+    QString name; // Kernel name, e.g. nvme0n1 or dm-0
+    QString label; // Device-mapper name if there is one, else the kernel name
+    QString kind; // "disk" (physical) or "virtual" (dm, md, zram, ...)
+    double readRate = 0; // B/s
+    double writeRate = 0;
+    double readIops = 0;
+    double writeIops = 0;
+    double utilization = 0; // Share of the interval with I/O in flight, 0-1; the busiest disk for the total
+    double latency = 0; // Mean ms per completed request
+
+    bool operator==(const DiskStats& other) const = default;
+};
+
+/// Everything SysMonitor publishes, collected in one pass. Snapshots are
+/// built on the sampler thread and handed to the GUI thread by value; the
+/// containers are implicitly shared, so this is cheap and never torn.
+struct SysSnapshot {
+    QVariantMap memory;
+    QVariantMap cpu;
+    CpuLoad cpuLoad;
+    QList<CpuLoad> coreLoads;
+    QList<qreal> coreFrequencies; // MHz, 0 where cpufreq is unavailable
+    QVariantList network; // Raw counters of the physical interfaces
+    QList<NetInterfaceStats> netInterfaces; // In /proc/net/dev order
+    NetInterfaceStats netTotal; // Physical interfaces only, so bridged or tunnelled traffic isn't counted twice
+    QVariantList disk; // Raw sector counters of the physical disks
+    QList<DiskStats> diskDevices; // Whole disks in /proc/diskstats order, partitions and loop devices excluded
+    DiskStats diskTotal; // Physical disks only, as dm/md I/O also shows up on the disks beneath
+    QList<ProcessRow> processes; // Top maxProcesses, in sortBy order
+    QVariantList threads; // Of the process selected with setThreadsPid(), busiest first
+    QVariantMap system;
+    QVariantList diskmounts; // mounts as maps, kept for existing bindings
+    QList<MountStats> mounts;
+    QVariantMap gpu; // The primary GPU, see gpus for all of them
+    QVariantList gpus;
+    QVariantMap pressure; // cpu, memory and io, empty without PSI
+    QVariantList userSlices; // By uid
+};
+
+/// Collects system metrics off the GUI thread. Lives on SysMonitor's worker
+/// thread; all slots are invoked queued and results come back via sampled().
+class SysSampler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SysSampler(QObject* parent = nullptr);
+
+    Q_INVOKABLE void init();
+    Q_INVOKABLE void sample(int collectors);
+    Q_INVOKABLE void probeSystem();
+    Q_INVOKABLE void probeGpu();
+
+    Q_INVOKABLE void setActiveCollectors(int collectors);
+    Q_INVOKABLE void setUpdateInterval(int interval);
+    Q_INVOKABLE void setMaxProcesses(int max);
+    Q_INVOKABLE void setSortBy(const QString& sort);
+    Q_INVOKABLE void setThreadsPid(int pid);
+    Q_INVOKABLE void setProcessGpu(bool enabled);
+    Q_INVOKABLE void setPressureThreshold(double threshold);
+
+signals:
+    void sampled(const caelestia::SysSnapshot& snapshot);
+    /// Follows the sampled() of a sample() call. Other snapshots, e.g. from
+    /// probes or mount and pressure notifications, aren't followed by it.
+    void sampleFinished();
+    void pressureStalled(const QString& resource);
+
+private:
+    void updateMemory();
+    void updateCpu();
+    void updateNetwork();
+    void updateDisk();
+    void updateProcesses();
+    void aggregateProcessTree();
+    void updateThreads();
+    void updateSystem();
+    void updateSystemInfo();
+    void updateDiskmounts();
+    void updateGpu();
+    void updateGpuInfo();
+    void updatePressure();
+    void updateUserSlices();
+
+    void updateCoreFrequencies();
+    void updateGpuTracking();
+    static void readCpuInfo(QVariantMap& cpu, bool needFrequency);
+    static QString networkKind(const QString& name);
+
+    void resolveCpuSensors();
+    void publish();
+
+    int m_activeCollectors = 0;
+    int m_updateInterval = 2000;
+    int m_maxProcesses = 100;
+    enum class SortKey {
+        Cpu,
+        Memory,
+        Pid,
+        Name,
+        TreeCpu,
+        Gpu,
+    };
+    SortKey m_sortKey = SortKey::Cpu;
+    bool m_processGpu = false;
+
+    SysSnapshot m_snapshot;
+    bool m_cpuInfoRead = false;
+    NvidiaTelemetry* m_nvidia;
+
+    procfs::ProcFile m_meminfoFile{ "/proc/meminfo" };
+    procfs::ProcFile m_statFile{ "/proc/stat" };
+    procfs::ProcFile m_netDevFile{ "/proc/net/dev" };
+    procfs::ProcFile m_diskstatsFile{ "/proc/diskstats" };
+    procfs::ProcFile m_loadavgFile{ "/proc/loadavg" };
+    procfs::ProcFile m_cpuTempFile;
+    MountTable m_mountTable;
+    QSocketNotifier* m_mountWatch = nullptr;
+    Pressure m_pressure;
+    std::array<QSocketNotifier*, Pressure::ResourceCount> m_pressureWatches{}; // On armed triggers
+    UserSlices m_userSlices;
+    DrmGpus m_drmGpus;
+    QString m_nvidiaAddress; // PCI address NvidiaTelemetry is open on
+    std::vector<procfs::ProcFile> m_coreFreqFiles;
+    std::vector<int> m_coreFreqIds;
+
+    // Jiffies from the previous /proc/stat read; [0] is the aggregate line
+    struct CpuTimes {
+        int cpu = -1; // logical CPU number, -1 for the aggregate
+        qint64 total = 0;
+        qint64 idle = 0; // idle + iowait
+        qint64 iowait = 0;
+        qint64 steal = 0;
+    };
+    std::vector<CpuTimes> m_lastCpuTimes;
+    std::vector<CpuTimes> m_cpuTimes;
+
+    // Counters from the previous /proc/net/dev read, by interface name
+    struct NetCounters {
+        QString kind;
+        qint64 rx = 0;
+        qint64 tx = 0;
+        qint64 rxBytes = 0;
+        qint64 txBytes = 0;
+        quint32 generation = 0;
+    };
+    QHash<QString, NetCounters> m_netCounters;
+    qint64 m_netReadNs = 0;
+    quint32 m_netGeneration = 0;
+
+    // Counters from the previous /proc/diskstats read, by device name
+    struct DiskCounters {
+        bool tracked = false; // Whole disk worth reporting
+        QString kind;
+        QString label;
+        qint64 reads = 0;
+        qint64 sectorsRead = 0;
+        qint64 readMs = 0;
+        qint64 writes = 0;
+        qint64 sectorsWritten = 0;
+        qint64 writeMs = 0;
+        qint64 ioTicks = 0; // ms with I/O in flight
+        quint32 generation = 0;
+    };
+    static DiskCounters diskInfo(const QString& name);
+    QHash<QString, DiskCounters> m_diskCounters;
+    qint64 m_diskReadNs = 0;
+    quint32 m_diskGeneration = 0;
+
+    ProcessTable m_processTable;
+    struct RankedProcess {
+        const ProcessEntry* entry;
+        double key; // Numeric sort key, larger first; unused for SortKey::Name
+        double cpu;
+        double memoryPercent;
+        double gpu;
+        double treeCpu;
+        qint64 treeMemoryKB;
+    };
+    std::vector<RankedProcess> m_ranked;
+    QHash<int, std::size_t> m_rankedByPid;
+
+    int m_threadsPid = -1;
+    std::vector<ThreadEntry> m_threads;
+    QHash<int, ThreadEntry> m_lastThreads; // By tid
+
+    // Process CPU calculation helpers
+    qint64 m_sysUptime = 0;
+    long m_clockTicks;
+    qint64 m_memTotalKB = 1;
+};
+
+} // namespace caelestia
+
+Q_DECLARE_METATYPE(caelestia::SysSnapshot)
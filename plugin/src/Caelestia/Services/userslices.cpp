@@ -0,0 +1,110 @@
+#include "userslices.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <pwd.h>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+namespace caelestia {
+
+namespace {
+
+constexpr const char* kUserSliceDir = "/sys/fs/cgroup/user.slice";
+
+} // namespace
+
+QVariantMap UserSliceStats::toVariantMap() const {
+    return {
+        { "slice", slice },
+        { "user", user },
+        { "uid", uid },
+        { "cpu", cpu },
+        { "memory", memoryBytes },
+    };
+}
+
+UserSlices::UserSlices()
+    : m_dir(opendir(kUserSliceDir)) {}
+
+UserSlices::~UserSlices() {
+    if (m_dir) closedir(m_dir);
+}
+
+void UserSlices::sample() {
+    if (!m_dir) return; // No unified hierarchy or not systemd; it won't appear later
+    rewinddir(m_dir);
+
+    const qint64 now = procfs::monotonicNs();
+    const double elapsedUs = m_sampleNs > 0 ? static_cast<double>(now - m_sampleNs) / 1e3 : 0;
+    m_sampleNs = now;
+    const quint32 generation = ++m_generation;
+
+    while (const dirent* ent = readdir(m_dir)) {
+        // user-<uid>.slice
+        const std::string_view name(ent->d_name);
+        if (!name.starts_with("user-") || !name.ends_with(".slice")) continue;
+        qint64 uid = -1;
+        if (!procfs::parseInt(name.substr(5, name.size() - 5 - 6), uid)) continue;
+
+        const QString slice = QString::fromUtf8(name.data(), static_cast<qsizetype>(name.size()));
+        auto it = std::ranges::find(m_slices, slice, [](const Slice& s) { return s.stats.slice; });
+        if (it == m_slices.end()) {
+            const std::string dir = std::string(kUserSliceDir) + "/" + ent->d_name;
+            Slice s;
+            s.stats.slice = slice;
+            s.stats.uid = static_cast<int>(uid);
+            s.stats.user = userName(s.stats.uid);
+            s.cpuStat.setPath(dir + "/cpu.stat");
+            s.memoryCurrent.setPath(dir + "/memory.current"); // Absent if memory accounting is off
+            m_slices.push_back(std::move(s));
+            it = std::prev(m_slices.end());
+        }
+        Slice& s = *it;
+        s.generation = generation;
+
+        // "usage_usec 123456\nuser_usec ...", available without the cpu controller
+        std::string_view text = s.cpuStat.read();
+        std::string_view line;
+        qint64 usage = -1;
+        while (procfs::nextLine(text, line)) {
+            if (procfs::nextField(line) == "usage_usec") {
+                procfs::nextInt(line, usage);
+                break;
+            }
+        }
+        s.stats.cpu = s.usageUs >= 0 && usage >= s.usageUs && elapsedUs > 0
+                          ? static_cast<double>(usage - s.usageUs) / elapsedUs * 100.0
+                          : 0;
+        s.usageUs = usage;
+
+        qint64 memory = 0;
+        s.stats.memoryBytes = s.memoryCurrent.readInt(memory) ? memory : 0;
+    }
+
+    // Users that logged out
+    std::erase_if(m_slices, [generation](const Slice& s) {
+        return s.generation != generation;
+    });
+
+    m_stats.clear();
+    m_stats.reserve(static_cast<qsizetype>(m_slices.size()));
+    for (const Slice& s : m_slices) {
+        m_stats.append(s.stats);
+    }
+    std::ranges::sort(m_stats, {}, &UserSliceStats::uid);
+}
+
+QString UserSlices::userName(int uid) {
+    passwd pw{};
+    passwd* result = nullptr;
+    std::vector<char> buffer(4096);
+    if (getpwuid_r(static_cast<uid_t>(uid), &pw, buffer.data(), buffer.size(), &result) == 0 && result) {
+        return QString::fromLocal8Bit(pw.pw_name);
+    }
+    return QString::number(uid);
+}
+
+} // namespace caelestia
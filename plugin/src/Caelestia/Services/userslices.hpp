@@ -0,0 +1,62 @@
+#pragma once
+
+#include "procfs.hpp"
+
+#include <qlist.h>
+#include <qstring.h>
+#include <qvariant.h>
+
+#include <dirent.h>
+#include <vector>
+
+namespace caelestia {
+
+/// CPU and memory charged to one logged-in user's systemd slice, i.e.
+/// everything they run, from the cgroup v2 hierarchy.
+struct UserSliceStats {
+    QString slice; // e.g. user-1000.slice
+    QString user; // Login name, or the uid if it can't be resolved
+    int uid = -1;
+    double cpu = 0; // % of one CPU over the last sampling interval
+    qint64 memoryBytes = 0; // memory.current, including page cache
+
+    bool operator==(const UserSliceStats& other) const = default;
+    [[nodiscard]] QVariantMap toVariantMap() const;
+};
+
+/// Walks /sys/fs/cgroup/user.slice on each sample() to follow users logging
+/// in and out, keeping each slice's files open while it exists. Empty on
+/// cgroup v1 or without systemd.
+class UserSlices {
+public:
+    UserSlices();
+    ~UserSlices();
+
+    UserSlices(const UserSlices&) = delete;
+    UserSlices& operator=(const UserSlices&) = delete;
+
+    void sample();
+    /// Makes the next sample() report no CPU, rather than the average over a
+    /// pause in sampling.
+    void restartWindow() { m_sampleNs = 0; }
+    [[nodiscard]] const QList<UserSliceStats>& slices() const { return m_stats; }
+
+private:
+    struct Slice {
+        UserSliceStats stats;
+        procfs::ProcFile cpuStat;
+        procfs::ProcFile memoryCurrent;
+        qint64 usageUs = -1; // cpu.stat usage_usec at the previous sample
+        quint32 generation = 0;
+    };
+
+    static QString userName(int uid);
+
+    DIR* m_dir;
+    std::vector<Slice> m_slices; // A handful at most, so found by linear search
+    QList<UserSliceStats> m_stats;
+    qint64 m_sampleNs = 0;
+    quint32 m_generation = 0;
+};
+
+} // namespace caelestia
@@ -0,0 +1,150 @@
+#include "fakeniri.hpp"
+#include "niricapture.hpp"
+#include "niriipc.hpp"
+
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qobject.h>
+#include <qsignalspy.h>
+#include <qtest.h>
+
+#include <unistd.h>
+
+using namespace caelestia;
+using namespace caelestia::test;
+
+namespace {
+
+qint64 residentBytes() {
+    // statm: size resident shared ... in pages
+    QFile file(QStringLiteral("/proc/self/statm"));
+    if (!file.open(QIODevice::ReadOnly)) return -1;
+    const QList<QByteArray> fields = file.readAll().split(' ');
+    return fields.size() > 1 ? fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE) : -1;
+}
+
+} // namespace
+
+/// Measures NiriIpc end to end, from FakeNiri writing an event to the socket
+/// to NiriIpc's change signals.
+class BenchNiriIpc : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void eventToSignalLatency();
+    void throughput_data();
+    void throughput();
+    void memoryGrowth();
+
+private:
+    /// Replays `events` and waits until NiriIpc has handled the last of them.
+    bool replayAndWait(const QList<QByteArray>& events);
+
+    QList<QByteArray> m_events;
+    FakeNiri* m_niri = nullptr;
+    NiriIpc* m_ipc = nullptr;
+    int m_sentinel = 0;
+};
+
+void BenchNiriIpc::initTestCase() {
+    m_events = loadNiriCapture(QStringLiteral("session.jsonl"));
+    QVERIFY(!m_events.isEmpty());
+}
+
+void BenchNiriIpc::init() {
+    m_niri = new FakeNiri(this);
+    QVERIFY(m_niri->listen());
+    m_ipc = new NiriIpc(this);
+    QTRY_VERIFY(m_ipc->available());
+    QTRY_COMPARE(m_niri->requests().size(), 5);
+}
+
+void BenchNiriIpc::cleanup() {
+    delete m_ipc;
+    m_ipc = nullptr;
+    delete m_niri;
+    m_niri = nullptr;
+}
+
+bool BenchNiriIpc::replayAndWait(const QList<QByteArray>& events) {
+    // Events are handled in order, so a keyboard layout no capture contains
+    // marks the end of the replay
+    const QString marker = QStringLiteral("sentinel %1").arg(++m_sentinel);
+    QList<QByteArray> replayed = events;
+    replayed.append(R"({"KeyboardLayoutsChanged":{"keyboard_layouts":{"names":[")" + marker.toUtf8() +
+                    R"("],"current_idx":0}}})");
+
+    QSignalSpy spy(m_ipc, &NiriIpc::keyboardChanged);
+    m_niri->replay(replayed);
+    while (m_ipc->kbLayouts() != marker) {
+        if (!spy.wait(10000)) return false;
+    }
+    return true;
+}
+
+void BenchNiriIpc::eventToSignalLatency() {
+    QVERIFY(replayAndWait(m_events));
+    const QVariantList windows = m_ipc->windows();
+    QVERIFY(windows.size() >= 2);
+    const QByteArray ids[] = {
+        QByteArray::number(windows.at(0).toMap().value(QStringLiteral("id")).toLongLong()),
+        QByteArray::number(windows.at(1).toMap().value(QStringLiteral("id")).toLongLong()),
+    };
+
+    // One focus change per iteration, alternating so each one is a change
+    QSignalSpy spy(m_ipc, &NiriIpc::focusedWindowChanged);
+    int i = 0;
+    QBENCHMARK {
+        m_niri->sendEvent(R"({"WindowFocusChanged":{"id":)" + ids[i++ % 2] + "}}");
+        QVERIFY(spy.wait(5000));
+    }
+}
+
+void BenchNiriIpc::throughput_data() {
+    QTest::addColumn<bool>("coalesce");
+
+    QTest::newRow("per event") << false;
+    QTest::newRow("coalesced") << true;
+}
+
+void BenchNiriIpc::throughput() {
+    QFETCH(bool, coalesce);
+    m_ipc->setCoalesceEvents(coalesce);
+
+    qint64 events = 0;
+    qint64 elapsedNs = 0;
+    QBENCHMARK {
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY(replayAndWait(m_events));
+        elapsedNs += timer.nsecsElapsed();
+        events += m_events.size() + 1;
+    }
+    const double perSecond = static_cast<double>(events) * 1e9 / static_cast<double>(elapsedNs);
+    qInfo().noquote() << QStringLiteral("%1 events/s").arg(perSecond, 0, 'f', 0);
+}
+
+void BenchNiriIpc::memoryGrowth() {
+    // Each replay starts from a full WindowsChanged, so state is bounded and
+    // whatever is still growing after a warm-up is a leak
+    static constexpr int kWarmup = 3;
+    static constexpr int kRounds = 20;
+    for (int i = 0; i < kWarmup; ++i) QVERIFY(replayAndWait(m_events));
+
+    const qint64 before = residentBytes();
+    QVERIFY(before > 0);
+    for (int i = 0; i < kRounds; ++i) QVERIFY(replayAndWait(m_events));
+    const qint64 growth = residentBytes() - before;
+
+    qInfo() << "RSS growth over" << kRounds * m_events.size() << "events:" << growth / 1024 << "KiB";
+    QTest::setBenchmarkResult(static_cast<qreal>(growth), QTest::BytesAllocated);
+    QVERIFY2(growth < 8 * 1024 * 1024, "Resident memory keeps growing while replaying");
+}
+
+QTEST_GUILESS_MAIN(BenchNiriIpc)
+
+#include "bench_niriipc.moc"
@@ -0,0 +1,172 @@
+#include "niricapture.hpp"
+#include "nirijson.hpp"
+#include "nirimodels.hpp"
+
+#include <qjsonarray.h>
+#include <qjsondocument.h>
+#include <qjsonobject.h>
+#include <qobject.h>
+#include <qtest.h>
+
+#include <string_view>
+#include <utility>
+
+using namespace caelestia;
+
+namespace {
+
+std::string_view view(const QByteArray& line) {
+    return { line.constData(), static_cast<std::size_t>(line.size()) };
+}
+
+bool enterField(NiriJsonReader& reader, std::string_view field) {
+    if (!reader.enterObject()) return false;
+    std::string_view key;
+    while (reader.nextKey(key)) {
+        if (key == field) return true;
+        if (!reader.skipValue()) return false;
+    }
+    return false;
+}
+
+/// Decodes an event the way NiriIpc::onEvent does, minus applying it. Returns
+/// the number of records decoded, or -1 on a decode error.
+qsizetype decodeWithReader(const QByteArray& line) {
+    NiriJsonReader reader(view(line));
+    std::string_view type;
+    if (!reader.enterObject() || !reader.nextKey(type)) return -1;
+
+    if (type == "WindowLayoutsChanged") {
+        QList<std::pair<qint64, NiriWindowLayout>> changes;
+        return enterField(reader, "changes") && readNiriLayoutChanges(reader, changes) ? changes.size() : -1;
+    } else if (type == "WindowOpenedOrChanged") {
+        NiriWindow window;
+        return enterField(reader, "window") && readNiriWindow(reader, window) ? 1 : -1;
+    } else if (type == "WindowFocusChanged" || type == "WindowClosed" || type == "WorkspaceActivated") {
+        const bool ok = enterField(reader, "id");
+        reader.readOptionalInt();
+        return ok && !reader.hasError() ? 1 : -1;
+    } else if (type == "WindowsChanged") {
+        QList<NiriWindow> windows;
+        return enterField(reader, "windows") && readNiriWindowList(reader, windows) ? windows.size() : -1;
+    } else if (type == "WorkspacesChanged") {
+        QList<NiriWorkspace> workspaces;
+        return enterField(reader, "workspaces") && readNiriWorkspaceList(reader, workspaces) ? workspaces.size()
+                                                                                              : -1;
+    } else if (type == "KeyboardLayoutsChanged" || type == "OverviewOpenedOrClosed" || type == "OutputsChanged") {
+        const std::string_view raw = reader.rawValue();
+        if (reader.hasError()) return -1;
+        return QJsonDocument::fromJson(QByteArray::fromRawData(raw.data(), static_cast<qsizetype>(raw.size())))
+                   .object()
+                   .size();
+    }
+    return 0; // Not handled
+}
+
+/// The previous path: a QJsonDocument per line, then converted again into
+/// variants for the handlers.
+qsizetype decodeWithDom(const QByteArray& line) {
+    const QJsonObject event = QJsonDocument::fromJson(line).object();
+    if (event.isEmpty()) return -1;
+    return event.begin().value().toObject().toVariantMap().size();
+}
+
+} // namespace
+
+/// Compares NiriJsonReader against QJsonDocument over recorded event streams
+/// in data/niri.
+class BenchNiriJson : public QObject {
+    Q_OBJECT
+
+private slots:
+    void readerMatchesDom_data() { addCaptures(); }
+    void readerMatchesDom();
+    void streamingReader_data() { addCaptures(); }
+    void streamingReader();
+    void jsonDocument_data() { addCaptures(); }
+    void jsonDocument();
+
+private:
+    static void addCaptures();
+};
+
+void BenchNiriJson::addCaptures() {
+    QTest::addColumn<QList<QByteArray>>("events");
+
+    for (const char* name : { "session.jsonl", "startup-3-outputs.jsonl" }) {
+        const QList<QByteArray> events = test::loadNiriCapture(QString::fromLatin1(name));
+        QVERIFY2(!events.isEmpty(), name);
+        QTest::newRow(name) << events;
+    }
+}
+
+void BenchNiriJson::readerMatchesDom() {
+    QFETCH(QList<QByteArray>, events);
+
+    for (const QByteArray& line : events) {
+        QVERIFY2(decodeWithReader(line) >= 0, line.constData());
+
+        const QJsonObject event = QJsonDocument::fromJson(line).object();
+        const QString type = event.begin().key();
+        const QJsonObject data = event.begin().value().toObject();
+        NiriJsonReader reader(view(line));
+        std::string_view key;
+        QVERIFY(reader.enterObject() && reader.nextKey(key));
+
+        if (type == "WindowsChanged") {
+            QList<NiriWindow> windows;
+            QVERIFY(enterField(reader, "windows") && readNiriWindowList(reader, windows));
+            const QJsonArray expected = data.value(QStringLiteral("windows")).toArray();
+            QCOMPARE(windows.size(), expected.size());
+            for (qsizetype i = 0; i < windows.size(); ++i) {
+                QVERIFY(windows.at(i) == NiriWindow::fromJson(expected.at(i).toObject()));
+            }
+        } else if (type == "WorkspacesChanged") {
+            QList<NiriWorkspace> workspaces;
+            QVERIFY(enterField(reader, "workspaces") && readNiriWorkspaceList(reader, workspaces));
+            const QJsonArray expected = data.value(QStringLiteral("workspaces")).toArray();
+            QCOMPARE(workspaces.size(), expected.size());
+            for (qsizetype i = 0; i < workspaces.size(); ++i) {
+                QVERIFY(workspaces.at(i) == NiriWorkspace::fromJson(expected.at(i).toObject()));
+            }
+        } else if (type == "WindowOpenedOrChanged") {
+            NiriWindow window;
+            QVERIFY(enterField(reader, "window") && readNiriWindow(reader, window));
+            QVERIFY(window == NiriWindow::fromJson(data.value(QStringLiteral("window")).toObject()));
+        } else if (type == "WindowLayoutsChanged") {
+            QList<std::pair<qint64, NiriWindowLayout>> changes;
+            QVERIFY(enterField(reader, "changes") && readNiriLayoutChanges(reader, changes));
+            const QJsonArray expected = data.value(QStringLiteral("changes")).toArray();
+            QCOMPARE(changes.size(), expected.size());
+            for (qsizetype i = 0; i < changes.size(); ++i) {
+                const QJsonArray change = expected.at(i).toArray();
+                QCOMPARE(changes.at(i).first, change.at(0).toInteger());
+                QVERIFY(changes.at(i).second == NiriWindowLayout::fromJson(change.at(1).toObject()));
+            }
+        }
+    }
+}
+
+void BenchNiriJson::streamingReader() {
+    QFETCH(QList<QByteArray>, events);
+
+    qsizetype decoded = 0;
+    QBENCHMARK {
+        for (const QByteArray& line : events) decoded += decodeWithReader(line);
+    }
+    QVERIFY(decoded > 0);
+}
+
+void BenchNiriJson::jsonDocument() {
+    QFETCH(QList<QByteArray>, events);
+
+    qsizetype decoded = 0;
+    QBENCHMARK {
+        for (const QByteArray& line : events) decoded += decodeWithDom(line);
+    }
+    QVERIFY(decoded > 0);
+}
+
+QTEST_GUILESS_MAIN(BenchNiriJson)
+
+#include "bench_nirijson.moc"
@@ -0,0 +1,221 @@
+#include "procfs.hpp"
+
+#include <qbytearray.h>
+#include <qfile.h>
+#include <qobject.h>
+#include <qregularexpression.h>
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qtest.h>
+#include <qtextstream.h>
+
+#include <string>
+#include <string_view>
+
+using namespace caelestia;
+
+namespace {
+
+enum class Fixture {
+    Meminfo,
+    Stat,
+    NetDev,
+    Diskstats,
+};
+
+std::string fixturePath(const char* name) {
+    return std::string(CAELESTIA_TEST_DATA) + "/proc/" + name;
+}
+
+// Each parser reduces the fields SysSampler reads from a file to a checksum,
+// so the two implementations can be checked against each other and the work
+// can't be optimised away.
+
+qint64 parseProcfs(Fixture fixture, std::string_view text) {
+    qint64 sum = 0;
+    std::string_view line;
+
+    switch (fixture) {
+    case Fixture::Meminfo:
+        while (procfs::nextLine(text, line)) {
+            const std::string_view key = procfs::nextField(line);
+            qint64 val = 0;
+            if (!procfs::nextInt(line, val)) continue;
+            if (key == "MemTotal:" || key == "MemFree:" || key == "MemAvailable:" || key == "Buffers:" ||
+                key == "Cached:" || key == "Shmem:" || key == "SwapTotal:" || key == "SwapFree:") {
+                sum += val;
+            }
+        }
+        break;
+    case Fixture::Stat:
+        while (procfs::nextLine(text, line)) {
+            if (!procfs::nextField(line).starts_with("cpu")) continue;
+            qint64 val = 0;
+            for (int i = 0; i < 8 && procfs::nextInt(line, val); ++i) sum += val;
+        }
+        break;
+    case Fixture::NetDev:
+        procfs::nextLine(text, line); // skip header
+        procfs::nextLine(text, line);
+        while (procfs::nextLine(text, line)) {
+            const auto colon = line.find(':');
+            if (colon == std::string_view::npos) continue;
+            std::string_view stats = line.substr(colon + 1);
+            qint64 fields[9] = {};
+            int parsed = 0;
+            while (parsed < 9 && procfs::nextInt(stats, fields[parsed])) ++parsed;
+            if (parsed == 9) sum += fields[0] + fields[8];
+        }
+        break;
+    case Fixture::Diskstats:
+        while (procfs::nextLine(text, line)) {
+            procfs::nextField(line); // major
+            procfs::nextField(line); // minor
+            procfs::nextField(line); // name
+            qint64 fields[10] = {};
+            int parsed = 0;
+            while (parsed < 10 && procfs::nextInt(line, fields[parsed])) ++parsed;
+            if (parsed == 10) sum += fields[2] + fields[6];
+        }
+        break;
+    }
+
+    return sum;
+}
+
+// The QTextStream/QRegularExpression parsing the collectors used before procfs
+qint64 parseQt(Fixture fixture, const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+    QByteArray content = file.readAll();
+    QTextStream in(&content);
+    QRegularExpression spaceRe("\\s+");
+    qint64 sum = 0;
+
+    if (fixture == Fixture::NetDev) {
+        in.readLine(); // skip header
+        in.readLine();
+    }
+
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        switch (fixture) {
+        case Fixture::Meminfo: {
+            const QStringList parts = line.split(spaceRe, Qt::SkipEmptyParts);
+            if (parts.size() < 2) continue;
+            static const QStringList keys = { "MemTotal:", "MemFree:", "MemAvailable:", "Buffers:", "Cached:",
+                "Shmem:", "SwapTotal:", "SwapFree:" };
+            if (keys.contains(parts[0])) sum += parts[1].toLongLong();
+            break;
+        }
+        case Fixture::Stat: {
+            if (!line.startsWith("cpu")) continue;
+            const QStringList parts = line.split(spaceRe, Qt::SkipEmptyParts);
+            for (int i = 1; i < parts.size() && i <= 8; ++i) sum += parts[i].toLongLong();
+            break;
+        }
+        case Fixture::NetDev: {
+            const QStringList parts = line.replace(':', ' ').split(" ", Qt::SkipEmptyParts);
+            if (parts.size() < 10) continue;
+            sum += parts[1].toLongLong() + parts[9].toLongLong();
+            break;
+        }
+        case Fixture::Diskstats: {
+            const QStringList parts = line.split(" ", Qt::SkipEmptyParts);
+            if (parts.size() < 14) continue;
+            sum += parts[5].toLongLong() + parts[9].toLongLong();
+            break;
+        }
+        }
+    }
+
+    return sum;
+}
+
+} // namespace
+
+Q_DECLARE_METATYPE(Fixture)
+
+/// Compares the procfs readers against the Qt text parsing they replaced, over
+/// /proc captures in data/proc.
+class BenchProcfs : public QObject {
+    Q_OBJECT
+
+private slots:
+    void parsersAgree_data() { addFixtures(); }
+    void parsersAgree();
+    void readReusesBuffer();
+    void byteReaders_data() { addFixtures(); }
+    void byteReaders();
+    void qtText_data() { addFixtures(); }
+    void qtText();
+
+private:
+    static void addFixtures();
+};
+
+void BenchProcfs::addFixtures() {
+    QTest::addColumn<Fixture>("fixture");
+    QTest::addColumn<QString>("path");
+
+    QTest::newRow("meminfo") << Fixture::Meminfo << QString::fromStdString(fixturePath("meminfo"));
+    QTest::newRow("stat") << Fixture::Stat << QString::fromStdString(fixturePath("stat"));
+    QTest::newRow("net/dev") << Fixture::NetDev << QString::fromStdString(fixturePath("net_dev"));
+    QTest::newRow("diskstats") << Fixture::Diskstats << QString::fromStdString(fixturePath("diskstats"));
+}
+
+void BenchProcfs::parsersAgree() {
+    QFETCH(Fixture, fixture);
+    QFETCH(QString, path);
+
+    procfs::ProcFile file(path.toStdString());
+    const std::string_view text = file.read();
+    QVERIFY(!text.empty());
+
+    const qint64 sum = parseProcfs(fixture, text);
+    QVERIFY(sum > 0);
+    QCOMPARE(sum, parseQt(fixture, path));
+}
+
+void BenchProcfs::readReusesBuffer() {
+    // Steady-state ticks must not reallocate: the second read of the same file
+    // lands in the buffer the first one grew
+    procfs::ProcFile file(fixturePath("stat"));
+    const std::string_view first = file.read();
+    QVERIFY(!first.empty());
+    const char* data = first.data();
+    const std::size_t size = first.size();
+
+    const std::string_view second = file.read();
+    QVERIFY(second.data() == data);
+    QCOMPARE(second.size(), size);
+}
+
+void BenchProcfs::byteReaders() {
+    QFETCH(Fixture, fixture);
+    QFETCH(QString, path);
+
+    procfs::ProcFile file(path.toStdString());
+    qint64 sum = 0;
+    QBENCHMARK {
+        sum += parseProcfs(fixture, file.read());
+    }
+    QVERIFY(sum > 0);
+}
+
+void BenchProcfs::qtText() {
+    QFETCH(Fixture, fixture);
+    QFETCH(QString, path);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        sum += parseQt(fixture, path);
+    }
+    QVERIFY(sum > 0);
+}
+
+QTEST_GUILESS_MAIN(BenchProcfs)
+
+#include "bench_procfs.moc"
@@ -0,0 +1,154 @@
+#include "fakeniri.hpp"
+
+#include <qdebug.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace caelestia::test {
+
+namespace {
+
+QByteArray joinLines(const QList<QByteArray>& lines) {
+    QByteArray data;
+    for (const QByteArray& line : lines) data.append(line).append('\n');
+    return data;
+}
+
+} // namespace
+
+FakeNiri::FakeNiri(QObject* parent)
+    : QObject(parent) {
+    connect(&m_server, &QLocalServer::newConnection, this, &FakeNiri::onNewConnection);
+    connect(&m_replayTimer, &QTimer::timeout, this, &FakeNiri::replayNext);
+
+    // An empty compositor, until a test says otherwise
+    setReply("\"Workspaces\"", R"({"Ok":{"Workspaces":[]}})");
+    setReply("\"Windows\"", R"({"Ok":{"Windows":[]}})");
+    setReply("\"FocusedWindow\"", R"({"Ok":{"FocusedWindow":null}})");
+    setReply("\"Outputs\"", R"({"Ok":{"Outputs":{}}})");
+    setReply("\"KeyboardLayouts\"", R"({"Ok":{"KeyboardLayouts":{"names":["English (US)"],"current_idx":0}}})");
+}
+
+FakeNiri::~FakeNiri() {
+    closeEventStreams();
+    m_server.close();
+}
+
+bool FakeNiri::listen() {
+    if (!m_dir.isValid() || !m_server.listen(m_dir.filePath(QStringLiteral("niri.sock")))) {
+        qWarning() << "FakeNiri: Failed to listen:" << m_server.errorString();
+        return false;
+    }
+    qputenv("NIRI_SOCKET", m_server.fullServerName().toLocal8Bit());
+    return true;
+}
+
+QString FakeNiri::socketPath() const {
+    return m_server.fullServerName();
+}
+
+void FakeNiri::setReply(const QByteArray& request, const QByteArray& reply) {
+    m_replies.insert(request, reply);
+}
+
+void FakeNiri::sendEvent(const QByteArray& line) {
+    writeToStreams(line + '\n');
+}
+
+void FakeNiri::replay(const QList<QByteArray>& events, int eventsPerSecond) {
+    if (eventsPerSecond <= 0) {
+        writeToStreams(joinLines(events));
+        emit replayFinished();
+        return;
+    }
+
+    // Timers don't go below a millisecond, so higher rates send batches
+    const qsizetype batch = std::max(1, eventsPerSecond / 1000);
+    m_replayChunks.clear();
+    for (qsizetype i = 0; i < events.size(); i += batch) {
+        m_replayChunks.append(joinLines(events.mid(i, batch)));
+    }
+    m_replayPos = 0;
+    m_replayTimer.start(std::max(1, 1000 / eventsPerSecond));
+}
+
+void FakeNiri::replayFragmented(const QList<QByteArray>& events, const QList<qsizetype>& splitPoints) {
+    const QByteArray data = joinLines(events);
+    m_replayChunks.clear();
+    qsizetype start = 0;
+    for (const qsizetype split : splitPoints) {
+        if (split <= start || split >= data.size()) continue;
+        m_replayChunks.append(data.mid(start, split - start));
+        start = split;
+    }
+    m_replayChunks.append(data.mid(start));
+    m_replayPos = 0;
+    m_replayTimer.start(0);
+}
+
+void FakeNiri::closeEventStreams() {
+    m_replayTimer.stop();
+    const QList<QLocalSocket*> streams = std::exchange(m_eventStreams, {});
+    for (QLocalSocket* sock : streams) {
+        sock->disconnect(this);
+        sock->disconnectFromServer();
+        sock->deleteLater();
+    }
+}
+
+void FakeNiri::onNewConnection() {
+    while (QLocalSocket* sock = m_server.nextPendingConnection()) {
+        // Every connection starts with a single request line
+        auto buffer = std::make_shared<QByteArray>();
+        connect(sock, &QLocalSocket::readyRead, this, [this, sock, buffer]() {
+            if (m_eventStreams.contains(sock)) {
+                sock->readAll(); // Clients don't send anything more on an event stream
+                return;
+            }
+            buffer->append(sock->readAll());
+            const qsizetype newline = buffer->indexOf('\n');
+            if (newline >= 0) onFirstLine(sock, buffer->left(newline).trimmed());
+        });
+        connect(sock, &QLocalSocket::disconnected, this, [this, sock]() {
+            m_eventStreams.removeOne(sock);
+            sock->deleteLater();
+        });
+    }
+}
+
+void FakeNiri::onFirstLine(QLocalSocket* sock, const QByteArray& line) {
+    if (line == "\"EventStream\"") {
+        m_eventStreams.append(sock);
+        sock->write("{\"Ok\":\"Handled\"}\n");
+        sock->flush();
+        emit eventStreamStarted();
+        return;
+    }
+
+    m_requests.append(line);
+    sock->write(m_replies.value(line, "{\"Ok\":\"Handled\"}") + '\n');
+    sock->flush();
+    sock->disconnectFromServer(); // One request per connection
+    emit requestReceived(line);
+}
+
+void FakeNiri::writeToStreams(const QByteArray& data) {
+    for (QLocalSocket* sock : std::as_const(m_eventStreams)) {
+        sock->write(data);
+        sock->flush();
+    }
+}
+
+void FakeNiri::replayNext() {
+    if (m_replayPos < m_replayChunks.size()) writeToStreams(m_replayChunks.at(m_replayPos++));
+
+    if (m_replayPos >= m_replayChunks.size()) {
+        m_replayTimer.stop();
+        m_replayChunks.clear();
+        emit replayFinished();
+    }
+}
+
+} // namespace caelestia::test
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <qbytearray.h>
+#include <qhash.h>
+#include <qlist.h>
+#include <qlocalserver.h>
+#include <qlocalsocket.h>
+#include <qobject.h>
+#include <qtemporarydir.h>
+#include <qtimer.h>
+
+namespace caelestia::test {
+
+/// Stand-in for niri's IPC socket. Listens on a socket in a temporary
+/// directory and points $NIRI_SOCKET at it, so the niri classes connect to it
+/// as they would to the compositor.
+///
+/// Like niri, a connection that sends "EventStream" is answered with
+/// {"Ok":"Handled"} and kept open for events; any other request is answered
+/// with its canned reply (or {"Ok":"Handled"}, as niri answers actions) and
+/// the connection is closed.
+class FakeNiri : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FakeNiri(QObject* parent = nullptr);
+    ~FakeNiri() override;
+
+    /// Starts listening and sets $NIRI_SOCKET. Returns false if it couldn't.
+    bool listen();
+    [[nodiscard]] QString socketPath() const;
+
+    /// Answers `request`, e.g. "\"Windows\"", with `reply` from now on.
+    void setReply(const QByteArray& request, const QByteArray& reply);
+    /// Requests received on request connections, in order of arrival.
+    [[nodiscard]] const QList<QByteArray>& requests() const { return m_requests; }
+    void clearRequests() { m_requests.clear(); }
+
+    [[nodiscard]] qsizetype eventStreamCount() const { return m_eventStreams.size(); }
+
+    /// Sends one event line to every event stream.
+    void sendEvent(const QByteArray& line);
+    /// Sends `events` to every event stream, at `eventsPerSecond` or, if 0,
+    /// all at once. Emits replayFinished() once the last one is written.
+    void replay(const QList<QByteArray>& events, int eventsPerSecond = 0);
+    /// Sends `events` cut into pieces at `splitPoints`, ascending byte offsets
+    /// into the stream, one piece per event loop pass so that readers get the
+    /// lines in fragments. Emits replayFinished() once the last one is written.
+    void replayFragmented(const QList<QByteArray>& events, const QList<qsizetype>& splitPoints);
+    /// Closes every event stream, as niri does when it exits.
+    void closeEventStreams();
+
+signals:
+    void eventStreamStarted();
+    void requestReceived(const QByteArray& request);
+    void replayFinished();
+
+private:
+    void onNewConnection();
+    void onFirstLine(QLocalSocket* sock, const QByteArray& line);
+    void writeToStreams(const QByteArray& data);
+    void replayNext();
+
+    QTemporaryDir m_dir;
+    QLocalServer m_server;
+    QList<QLocalSocket*> m_eventStreams;
+    QHash<QByteArray, QByteArray> m_replies;
+    QList<QByteArray> m_requests;
+
+    QTimer m_replayTimer;
+    QList<QByteArray> m_replayChunks; // Written one per timeout
+    qsizetype m_replayPos = 0;
+};
+
+} // namespace caelestia::test
@@ -0,0 +1,179 @@
+#include "fakeniri.hpp"
+#include "niricapture.hpp"
+#include "nirisocket.hpp"
+
+#include <qdebug.h>
+#include <qobject.h>
+#include <qrandom.h>
+#include <qtest.h>
+
+#include <memory>
+#include <utility>
+
+using namespace caelestia;
+using namespace caelestia::test;
+
+namespace {
+
+qsizetype streamSize(const QList<QByteArray>& events) {
+    qsizetype size = 0;
+    for (const QByteArray& line : events) size += line.size() + 1;
+    return size;
+}
+
+QList<qsizetype> randomSplits(qsizetype size, int minChunk, int maxChunk, quint32 seed) {
+    QRandomGenerator rng(seed);
+    QList<qsizetype> splits;
+    qsizetype pos = 0;
+    while ((pos += rng.bounded(minChunk, maxChunk + 1)) < size) splits.append(pos);
+    return splits;
+}
+
+QList<qsizetype> fixedSplits(qsizetype size, qsizetype chunk) {
+    QList<qsizetype> splits;
+    for (qsizetype pos = chunk; pos < size; pos += chunk) splits.append(pos);
+    return splits;
+}
+
+} // namespace
+
+/// Replays recorded event streams to NiriEventSocket cut into fragments, at
+/// random points and right around line ends, and checks that every event
+/// comes out whole and in order. Also times framing a large startup dump.
+class FuzzNiriSocket : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void randomFragments_data();
+    void randomFragments();
+    void splitAroundNewlines();
+    void largeDump_data();
+    void largeDump();
+
+private:
+    /// Replays `events` split at `splits` and returns the lines the socket emitted.
+    QList<QByteArray> receive(const QList<QByteArray>& events, const QList<qsizetype>& splits);
+
+    std::unique_ptr<FakeNiri> m_niri;
+    std::unique_ptr<NiriEventSocket> m_socket;
+    QList<QByteArray> m_received;
+};
+
+void FuzzNiriSocket::init() {
+    m_niri = std::make_unique<FakeNiri>();
+    QVERIFY(m_niri->listen());
+
+    m_received.clear();
+    m_socket = std::make_unique<NiriEventSocket>();
+    connect(m_socket.get(), &NiriEventSocket::eventReceived, this, [this](const QByteArray& line) {
+        m_received.append(line);
+    });
+    m_socket->connectToNiri();
+    QTRY_VERIFY(m_socket->isConnected());
+}
+
+void FuzzNiriSocket::cleanup() {
+    m_socket.reset();
+    m_niri.reset();
+}
+
+QList<QByteArray> FuzzNiriSocket::receive(const QList<QByteArray>& events, const QList<qsizetype>& splits) {
+    m_received.clear();
+    bool finished = false;
+    const auto conn = connect(m_niri.get(), &FakeNiri::replayFinished, this, [&finished]() {
+        finished = true;
+    });
+    m_niri->replayFragmented(events, splits);
+
+    // Everything is written by the time the replay finishes, so give the
+    // socket a last pass to read it
+    if (!QTest::qWaitFor([&]() { return finished && m_received.size() >= events.size(); }, 30000)) {
+        qWarning() << "FuzzNiriSocket: Timed out with" << m_received.size() << "of" << events.size() << "events";
+    }
+    disconnect(conn);
+    return std::exchange(m_received, {});
+}
+
+void FuzzNiriSocket::randomFragments_data() {
+    QTest::addColumn<QString>("capture");
+    QTest::addColumn<int>("minChunk");
+    QTest::addColumn<int>("maxChunk");
+    QTest::addColumn<quint32>("seed");
+
+    // Seeds are fixed so a failing row can be rerun as is
+    const auto addRows = [](const char* capture, int minChunk, int maxChunk, quint32 seeds) {
+        for (quint32 seed = 1; seed <= seeds; ++seed) {
+            QTest::addRow("%s, %d-%d bytes, seed %u", capture, minChunk, maxChunk, seed)
+                << QString::fromLatin1(capture) << minChunk << maxChunk << seed;
+        }
+    };
+    addRows("startup-3-outputs.jsonl", 1, 8, 2);
+    addRows("startup-3-outputs.jsonl", 1, 512, 4);
+    addRows("session.jsonl", 1, 512, 4);
+    addRows("session.jsonl", 256, 65536, 8);
+}
+
+void FuzzNiriSocket::randomFragments() {
+    QFETCH(QString, capture);
+    QFETCH(int, minChunk);
+    QFETCH(int, maxChunk);
+    QFETCH(quint32, seed);
+
+    const QList<QByteArray> events = loadNiriCapture(capture);
+    QVERIFY(!events.isEmpty());
+
+    QCOMPARE(receive(events, randomSplits(streamSize(events), minChunk, maxChunk, seed)), events);
+}
+
+void FuzzNiriSocket::splitAroundNewlines() {
+    const QList<QByteArray> events = loadNiriCapture(QStringLiteral("session.jsonl"));
+    QVERIFY(!events.isEmpty());
+
+    // Cut just before, just after and right at every line end, the boundaries
+    // the framer's scan cursor has to get right
+    QList<qsizetype> splits;
+    qsizetype end = -1;
+    for (qsizetype i = 0; i < events.size(); ++i) {
+        end += events.at(i).size() + 1;
+        const qsizetype cut = end + (i % 3) - 1;
+        if (splits.isEmpty() || cut > splits.constLast()) splits.append(cut);
+    }
+
+    QCOMPARE(receive(events, splits), events);
+}
+
+void FuzzNiriSocket::largeDump_data() {
+    QTest::addColumn<int>("copies");
+    QTest::addColumn<int>("chunk");
+
+    // Framing should scale with the size of the stream, not its square: four
+    // copies should take about four times as long as one
+    QTest::newRow("1 copy, 4 KiB reads") << 1 << 4096;
+    QTest::newRow("4 copies, 4 KiB reads") << 4 << 4096;
+    QTest::newRow("4 copies, 512 B reads") << 4 << 512;
+    QTest::newRow("4 copies, 64 KiB reads") << 4 << 65536;
+}
+
+void FuzzNiriSocket::largeDump() {
+    QFETCH(int, copies);
+    QFETCH(int, chunk);
+
+    const QList<QByteArray> capture = loadNiriCapture(QStringLiteral("startup-3-outputs.jsonl"));
+    QVERIFY(!capture.isEmpty());
+    QList<QByteArray> events;
+    for (int i = 0; i < copies; ++i) events.append(capture);
+    const QList<qsizetype> splits = fixedSplits(streamSize(events), chunk);
+
+    QList<QByteArray> received;
+    QBENCHMARK {
+        received = receive(events, splits);
+    }
+    QCOMPARE(received.size(), events.size());
+}
+
+QTEST_GUILESS_MAIN(FuzzNiriSocket)
+
+#include "fuzz_nirisocket.moc"
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <qbytearray.h>
+#include <qfile.h>
+#include <qlist.h>
+#include <qstring.h>
+
+namespace caelestia::test {
+
+/// Reads a recorded niri event stream from data/niri: one event per line, as
+/// niri sends them after the EventStream handshake. Returns an empty list if
+/// the capture is missing.
+inline QList<QByteArray> loadNiriCapture(const QString& name) {
+    QFile file(QStringLiteral(CAELESTIA_TEST_DATA "/niri/") + name);
+    if (!file.open(QIODevice::ReadOnly)) return {};
+
+    QList<QByteArray> lines;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (!line.isEmpty()) lines.append(line);
+    }
+    return lines;
+}
+
+} // namespace caelestia::test
@@ -0,0 +1,195 @@
+#include "fakeniri.hpp"
+#include "niricapture.hpp"
+#include "niriipc.hpp"
+
+#include <qjsonarray.h>
+#include <qjsondocument.h>
+#include <qjsonobject.h>
+#include <qobject.h>
+#include <qregularexpression.h>
+#include <qset.h>
+#include <qtest.h>
+
+#include <memory>
+
+using namespace caelestia;
+using namespace caelestia::test;
+
+namespace {
+
+/// What NiriIpc should end up with after a capture, worked out from the
+/// events directly.
+struct ExpectedState {
+    QSet<qint64> windowIds;
+    QString focusedWindowId;
+    qsizetype workspaceCount = 0;
+    bool inOverview = false;
+};
+
+ExpectedState expectedState(const QList<QByteArray>& events) {
+    ExpectedState state;
+    for (const QByteArray& line : events) {
+        const QJsonObject event = QJsonDocument::fromJson(line).object();
+        const QString type = event.begin().key();
+        const QJsonObject data = event.begin().value().toObject();
+
+        if (type == "WindowsChanged") {
+            state.windowIds.clear();
+            for (const auto& w : data.value(QStringLiteral("windows")).toArray()) {
+                state.windowIds.insert(w.toObject().value(QStringLiteral("id")).toInteger());
+            }
+        } else if (type == "WindowOpenedOrChanged") {
+            state.windowIds.insert(
+                data.value(QStringLiteral("window")).toObject().value(QStringLiteral("id")).toInteger());
+        } else if (type == "WindowClosed") {
+            state.windowIds.remove(data.value(QStringLiteral("id")).toInteger());
+        } else if (type == "WindowFocusChanged") {
+            const QJsonValue id = data.value(QStringLiteral("id"));
+            state.focusedWindowId = id.isNull() ? QString() : QString::number(id.toInteger());
+        } else if (type == "WorkspacesChanged") {
+            state.workspaceCount = data.value(QStringLiteral("workspaces")).toArray().size();
+        } else if (type == "OverviewOpenedOrClosed") {
+            state.inOverview = data.value(QStringLiteral("is_open")).toBool();
+        }
+    }
+    return state;
+}
+
+QSet<qint64> windowIds(const NiriIpc& ipc) {
+    QSet<qint64> ids;
+    for (const QVariant& w : ipc.windows()) ids.insert(w.toMap().value(QStringLiteral("id")).toLongLong());
+    return ids;
+}
+
+const QList<QByteArray> kStateQueries = {
+    "\"Workspaces\"",
+    "\"Windows\"",
+    "\"FocusedWindow\"",
+    "\"Outputs\"",
+    "\"KeyboardLayouts\"",
+};
+
+} // namespace
+
+/// Drives NiriIpc against FakeNiri.
+class TestNiriIpc : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void fetchesStateOnConnect();
+    void buildsStateFromEvents_data();
+    void buildsStateFromEvents();
+    void sendsActionsInOrder();
+    void rejectsUnknownActionWithArgs();
+    void reconnectsAfterRestart();
+
+private:
+    std::unique_ptr<FakeNiri> m_niri;
+};
+
+void TestNiriIpc::init() {
+    m_niri = std::make_unique<FakeNiri>();
+    QVERIFY(m_niri->listen());
+}
+
+void TestNiriIpc::cleanup() {
+    m_niri.reset();
+}
+
+void TestNiriIpc::fetchesStateOnConnect() {
+    m_niri->setReply("\"Windows\"", R"({"Ok":{"Windows":[)"
+                                     R"({"id":4,"title":"a","app_id":"kitty","pid":10,"workspace_id":1,)"
+                                     R"("is_focused":true,"is_floating":false,"is_urgent":false,"layout":null},)"
+                                     R"({"id":9,"title":"b","app_id":"firefox","pid":11,"workspace_id":1,)"
+                                     R"("is_focused":false,"is_floating":false,"is_urgent":false,"layout":null}]}})");
+    m_niri->setReply("\"FocusedWindow\"", R"({"Ok":{"FocusedWindow":{"id":4}}})");
+
+    NiriIpc ipc;
+    QTRY_VERIFY(ipc.available());
+    QTRY_COMPARE(m_niri->requests(), kStateQueries);
+    QTRY_COMPARE(windowIds(ipc), QSet<qint64>({ 4, 9 }));
+    QCOMPARE(ipc.focusedWindowId(), QStringLiteral("4"));
+    QCOMPARE(ipc.focusedWindowClass(), QStringLiteral("kitty"));
+    QCOMPARE(ipc.kbLayout(), QStringLiteral("en"));
+}
+
+void TestNiriIpc::buildsStateFromEvents_data() {
+    QTest::addColumn<QString>("capture");
+    QTest::addColumn<int>("eventsPerSecond");
+
+    QTest::newRow("session, at once") << QStringLiteral("session.jsonl") << 0;
+    QTest::newRow("session, 5000/s") << QStringLiteral("session.jsonl") << 5000;
+    QTest::newRow("3 outputs, at once") << QStringLiteral("startup-3-outputs.jsonl") << 0;
+}
+
+void TestNiriIpc::buildsStateFromEvents() {
+    QFETCH(QString, capture);
+    QFETCH(int, eventsPerSecond);
+
+    const QList<QByteArray> events = loadNiriCapture(capture);
+    QVERIFY(!events.isEmpty());
+    const ExpectedState expected = expectedState(events);
+
+    NiriIpc ipc;
+    QTRY_VERIFY(ipc.available());
+    QTRY_COMPARE(m_niri->requests().size(), kStateQueries.size());
+
+    m_niri->replay(events, eventsPerSecond);
+    QTRY_COMPARE_WITH_TIMEOUT(windowIds(ipc), expected.windowIds, 10000);
+    QTRY_COMPARE(ipc.workspaces().size(), expected.workspaceCount);
+    QCOMPARE(ipc.focusedWindowId(), expected.focusedWindowId);
+    QCOMPARE(ipc.inOverview(), expected.inOverview);
+}
+
+void TestNiriIpc::sendsActionsInOrder() {
+    NiriIpc ipc;
+    QTRY_VERIFY(ipc.available());
+    QTRY_COMPARE(m_niri->requests().size(), kStateQueries.size());
+    m_niri->clearRequests();
+
+    QVERIFY(ipc.focusWindow(7));
+    QVERIFY(ipc.action(QStringLiteral("set-column-width"), { QStringLiteral("+10%") }));
+    QVERIFY(ipc.closeWindow());
+    QVERIFY(ipc.action(QStringLiteral("focus-column"), { 2 }));
+
+    const QList<QByteArray> expected = {
+        R"({"Action":{"FocusWindow":{"id":7}}})",
+        R"({"Action":{"SetColumnWidth":{"change":{"AdjustProportion":10}}}})",
+        R"({"Action":{"CloseWindow":{"id":null}}})",
+        R"({"Action":{"FocusColumn":{"index":2}}})",
+    };
+    QTRY_COMPARE(m_niri->requests(), expected);
+}
+
+void TestNiriIpc::rejectsUnknownActionWithArgs() {
+    NiriIpc ipc;
+    QTRY_VERIFY(ipc.available());
+    QTRY_COMPARE(m_niri->requests().size(), kStateQueries.size());
+    m_niri->clearRequests();
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("Unknown action")));
+    QVERIFY(!ipc.action(QStringLiteral("frobnicate-window"), { 1 }));
+    QVERIFY(ipc.action(QStringLiteral("frobnicate-window")));
+    QTRY_COMPARE(m_niri->requests(), QList<QByteArray>({ R"({"Action":{"FrobnicateWindow":{}}})" }));
+}
+
+void TestNiriIpc::reconnectsAfterRestart() {
+    NiriIpc ipc;
+    QTRY_VERIFY(ipc.available());
+    QTRY_COMPARE(m_niri->requests().size(), kStateQueries.size());
+    m_niri->clearRequests();
+
+    m_niri->closeEventStreams();
+    QTRY_VERIFY(!ipc.available());
+
+    // The first reconnect is a second later
+    QTRY_VERIFY_WITH_TIMEOUT(ipc.available(), 5000);
+    QTRY_COMPARE(m_niri->requests(), kStateQueries);
+}
+
+QTEST_GUILESS_MAIN(TestNiriIpc)
+
+#include "tst_niriipc.moc"
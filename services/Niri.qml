@@ -196,7 +196,7 @@ Singleton {
 
     function switchToWorkspace(workspaceId) {
         if (!niriAvailable) return false;
-        return NiriIpc.action("focus-workspace", [workspaceId.toString()]);
+        return NiriIpc.focusWorkspace(workspaceId);
     }
 
     function switchToWorkspaceUpDown(direction) {
@@ -228,25 +228,31 @@ Singleton {
 
     function moveWindowToWorkspace(workspaceIdx) {
         if (!niriAvailable) return false;
-        return NiriIpc.action("move-window-to-workspace", [workspaceIdx.toString()]);
+        return NiriIpc.moveWindowToWorkspace(workspaceIdx);
     }
 
     // --- Window Functions ---
+    // Lookups go through NiriIpc's per-workspace index; reading `windows` keeps
+    // bindings that call these re-evaluating when the window list changes
     function getActiveWorkspaceWindows() {
         if (!allWorkspaces || focusedWorkspaceIndex === undefined) return [];
         const currentWs = allWorkspaces[focusedWorkspaceIndex];
         if (!currentWs?.id) return [];
-        return windows.filter(w => w.workspace_id === currentWs.id);
+        return getWindowsByWorkspaceId(currentWs.id);
     }
 
     function getWindowsByWorkspaceId(wsid) {
-        return windows.filter(w => w.workspace_id === wsid);
+        if (!windows) return [];
+        return NiriIpc.getWindowsByWorkspaceId(wsid);
     }
 
     function getWindowsByWorkspaceIndex(index) {
         if (index < 0 || index >= allWorkspaces.length) return [];
-        const wsId = allWorkspaces[index].id;
-        return windows.filter(w => w.workspace_id === wsId);
+        return getWindowsByWorkspaceId(allWorkspaces[index].id);
+    }
+
+    function getWorkspaceWindowsModel(wsid) {
+        return NiriIpc.workspaceWindowsModel(wsid);
     }
 
     function getWindowsInScreen(screenX, screenY, screenWidth, screenHeight, windowBorder, padding) {
@@ -286,24 +292,22 @@ Singleton {
         if (Number(windowID) === Number(focusedWindowId) && Config.bar.workspaces.doubleClickToCenter) {
             return centerWindow();
         }
-        return NiriIpc.action("focus-window", ["--id", windowID.toString()]);
+        return NiriIpc.focusWindow(Number(windowID));
     }
 
     function closeWindow(windowId) {
         if (!niriAvailable) return false;
-        const id = windowId ? windowId.toString() : focusedWindowId.toString();
-        return NiriIpc.action("close-window", ["--id", id]);
+        return NiriIpc.closeWindow(windowId ? Number(windowId) : Number(focusedWindowId || -1));
     }
 
     function closeFocusedWindow() {
         if (!niriAvailable) return false;
-        return NiriIpc.action("close-window", []);
+        return NiriIpc.closeWindow();
     }
 
     function toggleWindowFloating(windowId) {
         if (!niriAvailable) return false;
-        const id = windowId ? windowId.toString() : focusedWindowId.toString();
-        return NiriIpc.action("toggle-window-floating", ["--id", id]);
+        return NiriIpc.toggleWindowFloating(windowId ? Number(windowId) : Number(focusedWindowId || -1));
     }
 
     function toggleWindowOpacity() {
@@ -354,13 +358,13 @@ Singleton {
     function doScreenTransition(delayMs) {
         if (!niriAvailable) return false;
         var delay = delayMs !== undefined ? delayMs : 500;
-        return NiriIpc.action("do-screen-transition", ["-d", delay.toString()]);
+        return NiriIpc.doScreenTransition(delay);
     }
 
     function moveColumnToIndex(windowId, index) {
         if (!niriAvailable) return false;
         if (focusWindow(windowId)) {
-            return NiriIpc.action("move-column-to-index", [index.toString()]);
+            return NiriIpc.moveColumnToIndex(index);
         }
         return false;
     }
@@ -369,12 +373,12 @@ Singleton {
         if (!niriAvailable) return false;
         
         if (Number(windowId) === Number(focusedWindowId)) {
-            return NiriIpc.action("move-column-to-index", [index.toString()]);
+            return NiriIpc.moveColumnToIndex(index);
         }
         
         _moveAfterFocusPendingId = windowId.toString();
         _moveAfterFocusCb = function() {
-            NiriIpc.action("move-column-to-index", [index.toString()]);
+            NiriIpc.moveColumnToIndex(index);
         };
         
         focusWindow(windowId);
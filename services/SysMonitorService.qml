@@ -35,9 +35,6 @@ Singleton {
     property var perCoreCpuUsage: []
     property var perCoreCpuUsagePrev: []
 
-    property var lastCpuStats: null
-    property var lastPerCoreStats: null
-
     property real memoryUsage: 0
     property real totalMemoryMB: 0
     property real usedMemoryMB: 0
@@ -50,11 +47,9 @@ Singleton {
 
     property real networkRxRate: 0
     property real networkTxRate: 0
-    property var lastNetworkStats: null
 
     property real diskReadRate: 0
     property real diskWriteRate: 0
-    property var lastDiskStats: null
     property var diskMounts: []
 
     property int historySize: 60
@@ -231,26 +226,6 @@ Singleton {
         }
     }
 
-    function calculateCpuUsage(currentStats, lastStats) {
-        if (!lastStats || !currentStats || currentStats.length < 4) {
-            return 0;
-        }
-
-        const currentTotal = currentStats.reduce((sum, val) => sum + val, 0);
-        const lastTotal = lastStats.reduce((sum, val) => sum + val, 0);
-
-        const totalDiff = currentTotal - lastTotal;
-        if (totalDiff <= 0)
-            return 0;
-
-        const currentIdle = currentStats[3];
-        const lastIdle = lastStats[3];
-        const idleDiff = currentIdle - lastIdle;
-
-        const usedDiff = totalDiff - idleDiff;
-        return Math.max(0, Math.min(100, (usedDiff / totalDiff) * 100));
-    }
-
     Connections {
         target: SysMonitor
         
@@ -277,58 +252,27 @@ Singleton {
             cpuCount = data.count || 1;
             cpuFrequency = data.frequency || 0;
             cpuTemperature = data.temperature || 0;
+        }
 
-            if (data.total && data.total.length >= 8) {
-                // Ensure data.total and lastCpuStats are arrays
-                const usage = calculateCpuUsage(Array.from(data.total), lastCpuStats ? Array.from(lastCpuStats) : null);
-                cpuUsage = usage;
-                totalCpuUsage = usage;
-                lastCpuStats = Array.from(data.total);
-            }
-
-            if (data.cores) {
-                const coreUsages = [];
-                for (let i = 0; i < data.cores.length; i++) {
-                    const currentCoreStats = data.cores[i];
-                    if (currentCoreStats && currentCoreStats.length >= 8) {
-                        let lastCoreStats = lastPerCoreStats && lastPerCoreStats[i] ? lastPerCoreStats[i] : null;
-                        coreUsages.push(calculateCpuUsage(Array.from(currentCoreStats), lastCoreStats ? Array.from(lastCoreStats) : null));
-                    }
-                }
-                if (JSON.stringify(perCoreCpuUsage) !== JSON.stringify(coreUsages)) {
-                    perCoreCpuUsagePrev = [...perCoreCpuUsage];
-                    perCoreCpuUsage = coreUsages;
-                }
-                lastPerCoreStats = data.cores.map(core => Array.from(core));
-            }
+        function onCpuLoadChanged() {
+            cpuUsage = SysMonitor.cpuUsage * 100;
+            totalCpuUsage = cpuUsage;
+            perCoreCpuUsagePrev = perCoreCpuUsage;
+            perCoreCpuUsage = SysMonitor.coreUsage.map(usage => usage * 100);
         }
         
-        function onNetworkChanged() {
-            let n = SysMonitor.network;
-            let totalRx = 0, totalTx = 0;
-            for(let iface of n) { totalRx += iface.rx; totalTx += iface.tx; }
-            if (lastNetworkStats) {
-                const timeDiff = updateInterval / 1000;
-                networkRxRate = Math.max(0, (totalRx - lastNetworkStats.rx) / timeDiff);
-                networkTxRate = Math.max(0, (totalTx - lastNetworkStats.tx) / timeDiff);
-                addToHistory(networkHistory.rx, networkRxRate / 1024);
-                addToHistory(networkHistory.tx, networkTxRate / 1024);
-            }
-            lastNetworkStats = { "rx": totalRx, "tx": totalTx };
+        function onNetRatesChanged() {
+            networkRxRate = SysMonitor.netRxRate;
+            networkTxRate = SysMonitor.netTxRate;
+            addToHistory(networkHistory.rx, networkRxRate / 1024);
+            addToHistory(networkHistory.tx, networkTxRate / 1024);
         }
         
-        function onDiskChanged() {
-            let n = SysMonitor.disk;
-            let totalRead = 0, totalWrite = 0;
-            for(let d of n) { totalRead += d.read * 512; totalWrite += d.write * 512; }
-            if (lastDiskStats) {
-                const timeDiff = updateInterval / 1000;
-                diskReadRate = Math.max(0, (totalRead - lastDiskStats.read) / timeDiff);
-                diskWriteRate = Math.max(0, (totalWrite - lastDiskStats.write) / timeDiff);
-                addToHistory(diskHistory.read, diskReadRate / (1024 * 1024));
-                addToHistory(diskHistory.write, diskWriteRate / (1024 * 1024));
-            }
-            lastDiskStats = { "read": totalRead, "write": totalWrite };
+        function onDiskRatesChanged() {
+            diskReadRate = SysMonitor.diskReadRate;
+            diskWriteRate = SysMonitor.diskWriteRate;
+            addToHistory(diskHistory.read, diskReadRate / (1024 * 1024));
+            addToHistory(diskHistory.write, diskWriteRate / (1024 * 1024));
         }
         
         function onProcessesChanged() {
@@ -11,7 +11,7 @@ Singleton {
 
     // CPU properties
     property string cpuName: cleanCpuName(SysMonitor.cpu.model || "")
-    property real cpuPerc
+    readonly property real cpuPerc: SysMonitor.cpuUsage
     property real cpuTemp: SysMonitor.cpu.temperature || 0
 
     // GPU properties
@@ -39,9 +39,6 @@ Singleton {
     // Individual disks: Array of { mount, used, total, free, perc }
     property var disks: []
 
-    property real lastCpuIdle
-    property real lastCpuTotal
-
     property int refCount
 
     function cleanCpuName(name: string): string {
@@ -103,14 +100,16 @@ Singleton {
         };
     }
 
-    Timer {
-        running: root.refCount > 0
+    SysMonitorRef {
+        monitor: SysMonitor
+        collectors: root.refCount > 0 ? SysMonitor.Cpu | SysMonitor.Memory | SysMonitor.Gpu : 0
         interval: Config.dashboard.resourceUpdateInterval
-        repeat: true
-        triggeredOnStart: true
-        onTriggered: {
-            SysMonitor.updateAll();
-        }
+    }
+
+    // Disk usage changes slowly and statfs can be slow, so mounts keep their own default cadence
+    SysMonitorRef {
+        monitor: SysMonitor
+        collectors: root.refCount > 0 ? SysMonitor.Mounts : 0
     }
     
     Connections {
@@ -120,19 +119,6 @@ Singleton {
             let data = SysMonitor.cpu;
             root.cpuName = root.cleanCpuName(data.model || "");
             root.cpuTemp = data.temperature || 0;
-            
-            if (data.total && data.total.length >= 8) {
-                const totalArray = Array.from(data.total);
-                const total = totalArray.reduce((a, b) => a + b, 0);
-                const idle = totalArray[3] + (totalArray[4] || 0);
-
-                const totalDiff = total - root.lastCpuTotal;
-                const idleDiff = idle - root.lastCpuIdle;
-                root.cpuPerc = totalDiff > 0 ? (1 - idleDiff / totalDiff) : 0;
-
-                root.lastCpuTotal = total;
-                root.lastCpuIdle = idle;
-            }
         }
         
         function onMemoryChanged() {
@@ -149,12 +135,12 @@ Singleton {
             let diskList = [];
             for (let mount of mounts) {
                 if (mount.fstype !== "tmpfs" && mount.fstype !== "devtmpfs") {
-                    // C++ provides size in GB. We format disks in KiB, so GB * 1024 * 1024.
+                    // C++ provides sizes in bytes. We format disks in KiB.
                     diskList.push({
                         mount: mount.device,
-                        used: mount.used * 1024 * 1024,
-                        total: mount.size * 1024 * 1024,
-                        free: mount.avail * 1024 * 1024,
+                        used: mount.used / 1024,
+                        total: mount.size / 1024,
+                        free: mount.avail / 1024,
                         perc: mount.percent / 100.0
                     });
                 }